@@ -43,10 +43,34 @@
 #include <Wire.h>
 #endif
 
-U8G2_SSD1306_128X64_NONAME_1_SW_I2C u8g2(U8G2_R0, /* clock=*/ 18, /* data=*/ 17, /* reset=*/ 21);
+// Modo de buffer, escolhido por build flag (platformio.ini):
+//   DISPLAY_BUFFER_MODE=0  buffer completo (_F_): 1 KB de RAM, desenha uma vez por quadro
+//   DISPLAY_BUFFER_MODE=2  2 páginas (_2_): 256 bytes, repete o desenho 4 vezes por quadro
+//   DISPLAY_BUFFER_MODE=1  1 página (_1_): 128 bytes, repete o desenho 8 vezes por quadro
+#ifndef DISPLAY_BUFFER_MODE
+#define DISPLAY_BUFFER_MODE 0
+#endif
+
+// Clock do I2C por hardware; o SSD1306 do Heltec V3 aceita acima dos 400 kHz nominais
+#ifndef I2C_CLOCK_HZ
+#define I2C_CLOCK_HZ 400000
+#endif
+
+// Periférico I2C (não bit-banging) nos pinos do OLED: SCL 18, SDA 17, RST 21
+#if DISPLAY_BUFFER_MODE == 0
+U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, /* reset=*/ 21, /* clock=*/ 18, /* data=*/ 17);
+#elif DISPLAY_BUFFER_MODE == 2
+U8G2_SSD1306_128X64_NONAME_2_HW_I2C u8g2(U8G2_R0, /* reset=*/ 21, /* clock=*/ 18, /* data=*/ 17);
+#else
+U8G2_SSD1306_128X64_NONAME_1_HW_I2C u8g2(U8G2_R0, /* reset=*/ 21, /* clock=*/ 18, /* data=*/ 17);
+#endif
+
+void run_frame_benchmark(void);
 
 void setup(void) {
 
+  u8g2.setBusClock(I2C_CLOCK_HZ);
+
   // U8g2 SH1106 Proto-Shield
   //u8g2.begin(/* menu_select_pin= */ 2, /* menu_next_pin= */ 4, /* menu_prev_pin= */ 7, /* menu_up_pin= */ 6, /* menu_down_pin= */ 5, /* menu_home_pin= */ 3);
   
@@ -67,6 +91,10 @@ void setup(void) {
   //u8g2.begin(/*Select=*/ 7, /*Right/Next=*/ A1, /*Left/Prev=*/ A2, /*Up=*/ A0, /*Down=*/ A3, /*Home/Cancel=*/ 8); // Arduboy 10 (Production)
 
   u8g2.setFont(u8g2_font_6x12_tr);
+
+#ifdef FRAME_BENCHMARK
+  run_frame_benchmark();
+#endif
 }
 
 const char *string_list = 
@@ -106,3 +134,57 @@ void loop(void) {
   }
 }
 
+#ifdef FRAME_BENCHMARK
+
+#define BENCHMARK_FRAMES 100
+
+// Desenha um quadro da lista de seleção exatamente como o laço interno de
+// userInterfaceSelectionList(), sem esperar por botões
+void draw_selection_frame(const char *title, uint8_t position, const char *list) {
+  u8g2_t *u8g2_ptr = u8g2.getU8g2();
+  u8g2_uint_t line_height = u8g2_GetAscent(u8g2_ptr) - u8g2_GetDescent(u8g2_ptr) + 1;
+  uint8_t title_lines = u8x8_GetStringLineCnt(title);
+  u8sl_t u8sl;
+
+  u8sl.visible = (u8g2_GetDisplayHeight(u8g2_ptr) - 3) / line_height - title_lines;
+  u8sl.total = u8x8_GetStringLineCnt(list);
+  u8sl.current_pos = position % u8sl.total;
+  u8sl.first_pos = u8sl.current_pos >= u8sl.visible ? u8sl.current_pos - u8sl.visible + 1 : 0;
+
+  u8g2_SetFontPosBaseline(u8g2_ptr);
+  u8g2.firstPage();
+  do {
+    u8g2_uint_t yy = u8g2_GetAscent(u8g2_ptr);
+    yy += u8g2_DrawUTF8Lines(u8g2_ptr, 0, yy, u8g2_GetDisplayWidth(u8g2_ptr), line_height, title);
+    u8g2_DrawHLine(u8g2_ptr, 0, yy - line_height - u8g2_GetDescent(u8g2_ptr) + 1, u8g2_GetDisplayWidth(u8g2_ptr));
+    yy += 3;
+    u8g2_DrawSelectionList(u8g2_ptr, &u8sl, yy, list);
+  } while ( u8g2.nextPage() );
+}
+
+// Tempo por quadro ao percorrer a lista, como ao pressionar "next" repetidamente
+void run_frame_benchmark(void) {
+  Serial.begin(115200);
+
+  uint32_t min_us = UINT32_MAX;
+  uint32_t max_us = 0;
+  uint32_t total_us = 0;
+
+  for ( uint16_t i = 0; i < BENCHMARK_FRAMES; i++ ) {
+    uint32_t start = micros();
+    draw_selection_frame("Cloud Types", i, string_list);
+    uint32_t elapsed = micros() - start;
+
+    total_us += elapsed;
+    if ( elapsed < min_us ) min_us = elapsed;
+    if ( elapsed > max_us ) max_us = elapsed;
+  }
+
+  Serial.printf("Modo de buffer: %d, I2C: %lu Hz, buffer: %u bytes\n",
+    DISPLAY_BUFFER_MODE, (unsigned long)I2C_CLOCK_HZ,
+    u8g2.getBufferTileWidth() * u8g2.getBufferTileHeight() * 8);
+  Serial.printf("Quadro: media %lu us, min %lu us, max %lu us (%d quadros)\n",
+    (unsigned long)(total_us / BENCHMARK_FRAMES), (unsigned long)min_us, (unsigned long)max_us, BENCHMARK_FRAMES);
+}
+
+#endif
@@ -0,0 +1,318 @@
+// Micro-benchmarks do firmware no host (pio run -e native -t exec): tempo,
+// alocações e bytes I2C por operação. Os handlers de main.cpp rodam sobre os
+// stubs de hal/native; os números servem para comparar mudanças entre si, não
+// para prever o tempo no ESP32. O comportamento é verificado em test/
+// (pio test -e native), que compila sem este arquivo.
+
+#ifndef PIO_UNIT_TESTING
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <ESPAsyncWebServer.h>
+#include <log_ring.h>
+#include <relay_scheduler.h>
+#include <relay_outputs.h>
+#include <board_profile.h>
+#include <images.h>
+#include <images_paged.h>
+#include <ota_stream.h>
+#include <udp_control.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <vector>
+
+// Funções do firmware (src/main.cpp)
+void setup();
+void drawScreen(int screen);
+void redrawDisplay();
+void drawRelayTable(Adafruit_GFX &gfx, uint32_t mask);
+extern Adafruit_SSD1306 display;
+void handleGetRelayStatus(AsyncWebServerRequest *request);
+void handleRelayControl(AsyncWebServerRequest *request);
+void handleRelayBatch(AsyncWebServerRequest *request);
+void logMessage(LogLevel level, const char *format, ...);
+RelaySnapshot applyRelayMask(uint32_t target, uint32_t touch);
+uint32_t readRelayOutputs();
+extern RelayState relayState;
+
+const uint32_t BENCH_ITERATIONS = 20000;
+
+static std::atomic<uint64_t> allocationCount(0);
+
+// Conta também malloc/calloc/realloc (C, newlib, mbedtls), não só o new.
+// A biblioteca HTTP dos stubs aloca por fora (libraryMalloc).
+#ifdef __GLIBC__
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *p, size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(p, size);
+}
+#endif
+
+void *operator new(size_t size)
+{
+#ifndef __GLIBC__
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+#endif
+  void *p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+// Executa fn repetidamente e imprime ns/op, alocações/op e bytes I2C/op
+template <typename Fn>
+void runBench(const char *name, Fn fn)
+{
+  for (uint32_t i = 0; i < BENCH_ITERATIONS / 10; i++) // Aquecimento
+    fn(i);
+
+  Wire.resetCounters();
+  uint64_t allocations = allocationCount.load();
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t i = 0; i < BENCH_ITERATIONS; i++)
+    fn(i);
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  allocations = allocationCount.load() - allocations;
+
+  printf("%-24s %10.1f ns/op %8.2f allocs/op %8.1f i2c B/op\n", name,
+         (double)elapsed.count() / BENCH_ITERATIONS,
+         (double)allocations / BENCH_ITERATIONS,
+         (double)Wire.bytesSent / BENCH_ITERATIONS);
+}
+
+// Handlers do caminho quente não podem alocar depois do setup(). As respostas
+// em si são alocadas pela biblioteca e ficam fora da contagem (ver hal/native).
+template <typename Fn>
+bool checkZeroHeap(const char *name, Fn fn)
+{
+  uint64_t allocations = allocationCount.load();
+  for (uint32_t i = 0; i < 100; i++)
+    fn(i);
+  allocations = allocationCount.load() - allocations;
+
+  if (allocations != 0)
+    printf("FALHA: %s alocou %lu vezes em 100 chamadas\n", name, (unsigned long)allocations);
+  return allocations == 0;
+}
+
+
+// Caminho anterior da tabela de relés: bitmaps linha a linha, plotados pixel a pixel
+void drawRelayTableBitmaps(Adafruit_GFX &gfx, uint32_t mask)
+{
+  gfx.drawBitmap(1, 27, Table, 127, 36, 1);
+  gfx.drawBitmap(4, 33, OffArrayLabel, 120, 5, 1);
+
+  for (int i = 0; i < 7; i++)
+  {
+    if (mask & (1u << i))
+    {
+      gfx.drawBitmap(i * 18 + 3, 29, TableCell, 15, 14, 1);
+      gfx.drawBitmap(i * 18 + 6, 34, OnLabel, 9, 4, 0);
+    }
+  }
+}
+
+void udpCommand(uint8_t *packet, uint32_t session, uint32_t seq, uint32_t set, uint32_t clear)
+{
+  const uint32_t fields[] = {session, seq, set, clear};
+  packet[0] = UdpControl::MAGIC;
+  packet[1] = UdpControl::TYPE_COMMAND;
+  packet[2] = packet[3] = 0;
+  for (int i = 0; i < 4; i++)
+    for (int b = 0; b < 4; b++)
+      packet[4 + i * 4 + b] = fields[i] >> (b * 8);
+}
+
+void sha256(const uint8_t *data, size_t length, uint8_t digest[32])
+{
+  mbedtls_sha256_context context;
+  mbedtls_sha256_init(&context);
+  mbedtls_sha256_starts(&context, 0);
+  mbedtls_sha256_update(&context, data, length);
+  mbedtls_sha256_finish(&context, digest);
+  mbedtls_sha256_free(&context);
+}
+
+// OTA: imagem de 300 KB em pedaços do tamanho de um segmento TCP; a gravação
+// não pode alocar
+bool benchOtaStream()
+{
+  const size_t size = 300 * 1024 + 123;
+  std::vector<uint8_t> image(size);
+  uint32_t seed = 12345;
+  for (uint8_t &byte : image)
+  {
+    seed = seed * 1103515245 + 12345;
+    byte = seed >> 24;
+  }
+  image[0] = 0xE9;
+  uint8_t digest[32];
+  sha256(image.data(), size, digest);
+
+  static OtaStream ota;
+  const size_t chunk = 1436;
+  ota.begin(OtaTarget::Firmware, size, digest, 0);
+
+  uint64_t allocations = allocationCount.load();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t offset = 0; offset < size; offset += chunk)
+    ota.write(&image[offset], std::min(chunk, size - offset));
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  allocations = allocationCount.load() - allocations;
+  bool finished = ota.finish() == OtaResult::Ok;
+
+  printf("%-24s %10.1f MB/s   %8lu allocs\n", "otaStream.write", size / seconds / 1e6, (unsigned long)allocations);
+  return finished && allocations == 0;
+}
+
+int main()
+{
+  setup();
+
+  AsyncWebServerRequest request;
+
+  // Desenho + flush de cada tela (drawScreen, como na tarefa do display).
+  // As telas são retidas: sem mudança nos valores, o quadro não é refeito.
+  runBench("drawRelayStatusScreen", [](uint32_t) { drawScreen(0); });
+  // Quadro completo: custo de troca de tela / primeiro desenho
+  runBench("drawRelayStatusScreen*", [](uint32_t) {
+    redrawDisplay();
+    drawScreen(0);
+  });
+  runBench("drawWiFiStatusScreen", [](uint32_t) { drawScreen(1); });
+  runBench("drawWiFiStatusScreen*", [](uint32_t) {
+    redrawDisplay();
+    drawScreen(1);
+  });
+  runBench("drawESPInfoScreen", [](uint32_t) { drawScreen(2); });
+  runBench("drawLogScreen", [](uint32_t) { drawScreen(3); });
+
+  // Tabela de relés isolada, alternando entre os 128 estados: drawBitmap x blit por páginas
+  runBench("relayTable drawBitmap", [](uint32_t i) {
+    display.clearDisplay();
+    drawRelayTableBitmaps(display, i & 0x7F);
+  });
+  runBench("relayTable blitPaged", [](uint32_t i) {
+    display.clearDisplay();
+    drawRelayTable(display, i & 0x7F);
+  });
+  redrawDisplay();
+
+  runBench("handleGetRelayStatus", [&](uint32_t) {
+    request.clear();
+    handleGetRelayStatus(&request);
+  });
+
+  runBench("handleGetRelayStatus?mask", [&](uint32_t) {
+    request.clear();
+    request.setArg("format", "mask");
+    handleGetRelayStatus(&request);
+  });
+
+  // Alterna um relé por iteração: inclui notificação e log (a escrita nas saídas é do atuador)
+  runBench("handleRelayControl", [&](uint32_t i) {
+    static const char *numbers[] = {"0", "1", "2", "3", "4", "5", "6"};
+    request.clear();
+    request.setArg("relay", numbers[i % 7]);
+    request.setArg("state", (i / 7) & 1 ? "off" : "on");
+    handleRelayControl(&request);
+  });
+
+  // Datagrama UDP completo: seq, comando e ack. Com chave, a tag do bench não
+  // confere: mede a verificação do HMAC e o ack com o desafio (outra tag)
+  static UdpControl benchControl;
+  static uint8_t udpPacket[UdpControl::MAX_PACKET_SIZE];
+  static uint8_t udpReply[UdpControl::MAX_ACK_SIZE];
+  for (const char *key : {"", "bench-key"})
+  {
+    benchControl.begin(RelayOutputs::COUNT, key, applyRelayMask, readRelayOutputs);
+    runBench(*key ? "udpCommand+hmac" : "udpCommand", [](uint32_t i) {
+      size_t replyLength;
+      udpCommand(udpPacket, 1, i + 1, i & 1 ? 0x04 : 0, i & 1 ? 0 : 0x04);
+      benchControl.handle(udpPacket, UdpControl::MAX_PACKET_SIZE, udpReply, replyLength);
+    });
+  }
+
+  runBench("logMessage", [](uint32_t i) { logMessage(LogLevel::Info, "Bench %lu", (unsigned long)i); });
+
+  // Caminho dos handlers: comando no RelayState + notificação, sem esperar a comutação
+  runBench("applyRelayMask", [](uint32_t i) { applyRelayMask(i & 1 ? 0x04 : 0, 0x04); });
+
+  // Agenda cheia de jobs recorrentes: um passo da timing wheel por tick
+  static RelayScheduler benchScheduler;
+  static ScheduledAction due[RelayScheduler::CAPACITY];
+  for (int i = 0; i < RelayScheduler::CAPACITY; i++)
+    benchScheduler.add({RelayAction::Toggle, 1u << (i % 7), (uint32_t)(i * 7 % 1000), 100 + (uint32_t)(i * 37 % 5000),
+                        0, -1},
+                       0);
+  static uint32_t schedulerNow = 0; // Relógio virtual compartilhado pelas duas medidas
+  runBench("scheduler step", [](uint32_t) {
+    size_t count;
+    schedulerNow += RelayScheduler::TICK_MS;
+    while (benchScheduler.step(schedulerNow, due, count))
+    {
+    }
+  });
+  runBench("scheduler nextStepMs", [](uint32_t) {
+    volatile uint32_t wait = benchScheduler.nextStepMs(schedulerNow);
+    (void)wait;
+  });
+
+  // Monta as requisições antes da contagem: args e headers são da biblioteca
+  static const char *formats[] = {"named", "array", "mask"};
+  AsyncWebServerRequest statusRequests[3];
+  for (int i = 0; i < 3; i++)
+    statusRequests[i].setArg("format", formats[i]);
+
+  AsyncWebServerRequest relayRequests[2];
+  relayRequests[0].setArg("relay", "2");
+  relayRequests[0].setArg("state", "on");
+  relayRequests[1].setArg("relay", "2");
+  relayRequests[1].setArg("state", "off");
+
+  AsyncWebServerRequest batchRequest;
+  batchRequest.setArg("mask", "0x55");
+  batchRequest.setArg("touch", "0x7f");
+
+  bool zeroHeap = true;
+  zeroHeap &= checkZeroHeap("handleGetRelayStatus", [&](uint32_t i) { handleGetRelayStatus(&statusRequests[i % 3]); });
+  zeroHeap &= checkZeroHeap("handleRelayControl", [&](uint32_t i) { handleRelayControl(&relayRequests[i & 1]); });
+  zeroHeap &= checkZeroHeap("handleRelayBatch", [&](uint32_t) { handleRelayBatch(&batchRequest); });
+
+  // since = versão atual: caminho do 304 de um poller ocioso
+  char sinceVersion[12];
+  snprintf(sinceVersion, sizeof(sinceVersion), "%lu", (unsigned long)relayState.snapshot().version);
+  AsyncWebServerRequest sinceRequest;
+  sinceRequest.setArg("since", sinceVersion);
+  zeroHeap &= checkZeroHeap("handleGetRelayStatus?since", [&](uint32_t) { handleGetRelayStatus(&sinceRequest); });
+
+  zeroHeap &= benchOtaStream();
+
+  printf("zero-heap: %s\n", zeroHeap ? "ok" : "FALHA");
+  return zeroHeap ? 0 : 1;
+}
+
+#endif
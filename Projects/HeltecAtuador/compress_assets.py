@@ -0,0 +1,39 @@
+Import("env")
+
+import gzip
+import hashlib
+import os
+
+# Gera data/<arquivo>.gz para o servidor enviar com Content-Encoding: gzip.
+# O index.html referencia o CSS/JS com ?v=<hash>, permitindo cache longo
+# (immutable) nesses arquivos sem servir versões antigas após um upload.
+DATA_DIR = os.path.join(env.subst("$PROJECT_DIR"), "data")
+VERSIONED_ASSETS = ["style.css", "script.js"]
+
+
+def read(name):
+    with open(os.path.join(DATA_DIR, name), "rb") as file:
+        return file.read()
+
+
+def write_gzip(name, content):
+    # mtime fixo: mesmo conteúdo gera o mesmo .gz (e o mesmo ETag no ESP32)
+    compressed = gzip.compress(content, compresslevel=9, mtime=0)
+    path = os.path.join(DATA_DIR, name + ".gz")
+    if os.path.exists(path):
+        with open(path, "rb") as file:
+            if file.read() == compressed:
+                return
+    with open(path, "wb") as file:
+        file.write(compressed)
+    print("compress_assets: %s.gz (%d -> %d bytes)" % (name, len(content), len(compressed)))
+
+
+index = read("index.html")
+for name in VERSIONED_ASSETS:
+    content = read(name)
+    version = hashlib.sha1(content).hexdigest()[:8]
+    index = index.replace(('"/%s"' % name).encode(), ('"/%s?v=%s"' % (name, version)).encode())
+    write_gzip(name, content)
+
+write_gzip("index.html", index)
@@ -0,0 +1,82 @@
+import os
+import re
+
+# Converte os bitmaps de src/images.h (linha a linha, MSB à esquerda, formato
+# do drawBitmap) para o layout de páginas do SSD1306 em src/images_paged.h,
+# permitindo desenhá-los com blitPaged em vez de pixel a pixel.
+# Roda como pre-script do PlatformIO ou direto: python convert_images.py
+try:
+    Import("env")
+    PROJECT_DIR = env.subst("$PROJECT_DIR")
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+SOURCE = os.path.join(PROJECT_DIR, "src", "images.h")
+OUTPUT = os.path.join(PROJECT_DIR, "src", "images_paged.h")
+
+# images.h não guarda as dimensões: as mesmas usadas nas chamadas a drawBitmap
+IMAGES = {
+    "BootLogo": (128, 64),
+    "Table": (127, 36),
+    "TableCell": (15, 14),
+    "OnLabel": (9, 4),
+    "OffArrayLabel": (120, 5),
+}
+
+
+def parse_arrays(text):
+    arrays = {}
+    for match in re.finditer(r"(\w+)\s*\[\]\s*(?:PROGMEM\s*)?=\s*\{([^}]*)\}", text):
+        arrays[match.group(1)] = [int(value, 16) for value in re.findall(r"0x[0-9a-fA-F]+", match.group(2))]
+    return arrays
+
+
+def to_pages(name, data, width, height):
+    row_bytes = (width + 7) // 8
+    if len(data) != row_bytes * height:
+        raise ValueError("%s: %d bytes, esperado %d para %dx%d" % (name, len(data), row_bytes * height, width, height))
+
+    pages = []
+    for page in range((height + 7) // 8):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < height and data[y * row_bytes + x // 8] & (0x80 >> (x % 8)):
+                    byte |= 1 << bit
+            pages.append(byte)
+    return pages
+
+
+def format_bytes(values):
+    lines = []
+    for i in range(0, len(values), 16):
+        lines.append("    " + ", ".join("0x%02x" % value for value in values[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+with open(SOURCE) as file:
+    arrays = parse_arrays(file.read())
+
+output = [
+    "// Gerado por convert_images.py a partir de images.h; não editar.",
+    "#pragma once",
+    "",
+    "#include <page_blit.h>",
+    "",
+]
+for name, (width, height) in IMAGES.items():
+    pages = to_pages(name, arrays[name], width, height)
+    output.append("static const uint8_t %sPages[] PROGMEM = {\n%s\n};" % (name, format_bytes(pages)))
+    output.append("static constexpr PagedBitmap %sPaged = {%d, %d, %sPages};" % (name, width, height, name))
+    output.append("")
+
+content = "\n".join(output)
+previous = None
+if os.path.exists(OUTPUT):
+    with open(OUTPUT) as file:
+        previous = file.read()
+if previous != content:
+    with open(OUTPUT, "w") as file:
+        file.write(content)
+    print("convert_images: %s (%d imagens)" % (os.path.relpath(OUTPUT, PROJECT_DIR), len(IMAGES)))
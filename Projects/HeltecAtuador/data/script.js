@@ -5,24 +5,109 @@ function toggleRelay(relayNum, state) {
 }
 
 window.onload = function() {
+  let polling = 0; // Identifica o laço de long-poll ativo (0 = parado)
+  let relayCount = 0;
+  let version = null;
+
+  // Cria um interruptor por relé; a quantidade vem do perfil da placa ("n" do /status)
+  function buildRelayToggles(count) {
+    const form = document.getElementById("relay-form");
+    for (let i = relayCount; i < count; i++) {
+      const row = document.createElement("div");
+      row.className = "relay-toggle";
+      row.innerHTML =
+        `<div class="col"><label>Output ${i + 1}</label></div>` +
+        `<div class="col"><label class="switch-container">` +
+        `<input type="checkbox" id="relay${i + 1}" class="checkbox" onclick="toggleRelay(${i}, this.checked)">` +
+        `<span class="switch"><span class="slider"></span></span></label></div>`;
+      form.appendChild(row);
+    }
+    relayCount = Math.max(relayCount, count);
+  }
+
+  // Aplica um estado em bitmask ("s") apenas aos relés alterados ("c")
+  function applyRelayMask(state, changed) {
+    for (let i = 0; i < relayCount; i++) {
+      if (changed & (1 << i)) {
+        document.getElementById(`relay${i + 1}`).checked = (state & (1 << i)) !== 0;
+      }
+    }
+  }
+
   // Função para atualizar o status dos relés
-  function updateRelayStatus() {
+  function updateRelayStatus(onLoaded) {
     const xhr = new XMLHttpRequest();
-    xhr.open("GET", "/status", true);
+    xhr.open("GET", "/status?format=mask", true);
     xhr.onload = function() {
       if (xhr.status === 200) {
         const status = JSON.parse(xhr.responseText);
-        for (let i = 0; i < 7; i++) {
-          document.getElementById(`relay${i + 1}`).checked = status[`relay${i}`];
+        buildRelayToggles(status.n);
+        applyRelayMask(status.s, ~0);
+        version = status.v;
+        if (onLoaded) {
+          onLoaded();
         }
+      } else if (onLoaded) {
+        setTimeout(() => updateRelayStatus(onLoaded), 2000);
+      }
+    };
+    xhr.onerror = function() {
+      if (onLoaded) {
+        setTimeout(() => updateRelayStatus(onLoaded), 2000);
+      }
+    };
+    xhr.send();
+  }
+
+  // Long-poll, usado só quando o canal de eventos falha: o /status responde
+  // quando o estado muda (só os relés alterados desde "since") ou 304 no prazo
+  function poll(loop) {
+    if (loop !== polling) {
+      return;
+    }
+    const xhr = new XMLHttpRequest();
+    xhr.open("GET", `/status?format=mask&since=${version}&wait=25000`, true);
+    xhr.onload = function() {
+      if (xhr.status === 200) {
+        const status = JSON.parse(xhr.responseText);
+        applyRelayMask(status.s, "c" in status ? status.c : ~0);
+        version = status.v;
       }
+      setTimeout(() => poll(loop), xhr.status === 200 || xhr.status === 304 ? 0 : 2000);
+    };
+    xhr.onerror = function() {
+      setTimeout(() => poll(loop), 2000);
     };
     xhr.send();
   }
 
-  // Chama a função uma vez ao carregar a página
-  updateRelayStatus();
+  function startPolling() {
+    if (polling === 0) {
+      polling = Date.now();
+      poll(polling);
+    }
+  }
+
+  function stopPolling() {
+    polling = 0;
+  }
+
+  function connectEvents() {
+    if (!window.EventSource) {
+      startPolling();
+      return;
+    }
+
+    const events = new EventSource("/events");
+    events.addEventListener("state", function(e) {
+      const delta = JSON.parse(e.data);
+      applyRelayMask(delta.s, delta.c);
+      version = delta.v;
+    });
+    events.onopen = stopPolling;
+    events.onerror = startPolling;
+  }
 
-  // Atualiza o status dos relés a cada 5 segundos
-  setInterval(updateRelayStatus, 5000);
-};
\ No newline at end of file
+  // Monta os interruptores antes de abrir o canal de eventos
+  updateRelayStatus(connectEvents);
+};
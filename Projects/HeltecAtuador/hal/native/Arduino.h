@@ -0,0 +1,68 @@
+#pragma once
+
+// Subconjunto do core Arduino/ESP32 para o build nativo (host) do HeltecAtuador
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <esp_attr.h>
+#include <WString.h>
+#include <Print.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+uint32_t esp_random();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+
+// Sem SNTP no host: o relógio do sistema já está certo
+void configTzTime(const char *tz, const char *server1, const char *server2 = nullptr, const char *server3 = nullptr);
+
+class HardwareSerial : public Print
+{
+public:
+  void begin(unsigned long baud) {}
+  size_t write(uint8_t c) override { return 1; } // Descarta a saída durante os benchmarks
+  size_t write(const uint8_t *buffer, size_t size) override { return size; }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass
+{
+public:
+  void restart();
+  uint64_t getEfuseMac() { return 0x0000AABBCCDDEEFFull; }
+  uint8_t getChipCores() { return 2; }
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint32_t getFlashChipSize() { return 8 * 1024 * 1024; }
+  uint32_t getHeapSize() { return 320 * 1024; }
+  uint32_t getFreeHeap() { return 200 * 1024; }
+  uint32_t getMinFreeHeap() { return 180 * 1024; }
+  uint32_t getMaxAllocHeap() { return 110 * 1024; }
+};
+
+extern EspClass ESP;
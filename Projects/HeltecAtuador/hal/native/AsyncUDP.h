@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+
+// Datagrama recebido; write() responde ao remetente (no host, só registra)
+class AsyncUDPPacket
+{
+public:
+  AsyncUDPPacket(const uint8_t *data, size_t length) : payload(data), size(length) {}
+
+  const uint8_t *data() { return payload; }
+  size_t length() { return size; }
+  size_t write(const uint8_t *data, size_t length)
+  {
+    replies++;
+    return length;
+  }
+
+  int replies = 0;
+
+private:
+  const uint8_t *payload;
+  size_t size;
+};
+
+typedef std::function<void(AsyncUDPPacket &packet)> AuPacketHandlerFunction;
+
+// Sem socket no host: o bench entrega datagramas com receive()
+class AsyncUDP
+{
+public:
+  bool listen(uint16_t port) { return true; }
+  void onPacket(AuPacketHandlerFunction callback) { handler = callback; }
+
+  void receive(AsyncUDPPacket &packet)
+  {
+    if (handler)
+      handler(packet);
+  }
+
+private:
+  AuPacketHandlerFunction handler;
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Conexão de rede usada pelo PubSubClient; no host não há socket
+class Client
+{
+public:
+  virtual ~Client() {}
+  virtual int available() { return 0; }
+};
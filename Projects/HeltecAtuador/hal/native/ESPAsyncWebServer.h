@@ -0,0 +1,239 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Servidor assíncrono simulado: as rotas não são despachadas; os benchmarks
+// montam um AsyncWebServerRequest e chamam os handlers diretamente.
+
+typedef enum
+{
+  HTTP_GET = 0b00000001,
+  HTTP_POST = 0b00000010,
+  HTTP_DELETE = 0b00000100,
+  HTTP_PUT = 0b00001000,
+  HTTP_PATCH = 0b00010000,
+  HTTP_HEAD = 0b00100000,
+  HTTP_OPTIONS = 0b01000000,
+  HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest;
+class AsyncEventSourceClient;
+
+typedef std::function<size_t(uint8_t *buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, const String &filename, size_t index, uint8_t *data,
+                           size_t len, bool final)>
+    ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)>
+    ArBodyHandlerFunction;
+typedef std::function<void(void)> ArDisconnectHandler;
+typedef std::function<void(AsyncEventSourceClient *client)> ArEventHandlerFunction;
+
+// Heap da biblioteca: não passa pelo malloc contado nos benchmarks (hal_native.cpp)
+void *libraryMalloc(size_t size);
+void libraryFree(void *p);
+
+// Alocador dos contêineres internos da biblioteca (ex.: headers da resposta):
+// fora da contagem de alocações dos benchmarks, como a própria resposta
+template <typename T>
+struct LibraryAllocator
+{
+  typedef T value_type;
+
+  LibraryAllocator() {}
+  template <typename U>
+  LibraryAllocator(const LibraryAllocator<U> &) {}
+
+  T *allocate(size_t n) { return (T *)libraryMalloc(n * sizeof(T)); }
+  void deallocate(T *p, size_t) { libraryFree(p); }
+
+  template <typename U>
+  bool operator==(const LibraryAllocator<U> &) const { return true; }
+  template <typename U>
+  bool operator!=(const LibraryAllocator<U> &) const { return false; }
+};
+
+class AsyncWebServerResponse
+{
+public:
+  // O tipo não é guardado: a cópia dele é custo da biblioteca, não do firmware
+  AsyncWebServerResponse(int code, const String &contentType) : code(code) {}
+  virtual ~AsyncWebServerResponse() {}
+
+  // Alocação da biblioteca, fora do código do firmware: não entra na
+  // contagem de alocações dos benchmarks
+  static void *operator new(size_t size) { return libraryMalloc(size); }
+  static void operator delete(void *p) { libraryFree(p); }
+
+  void addHeader(const String &name, const String &value) { headers.push_back(std::make_pair(name, value)); }
+  void setCode(int c) { code = c; }
+
+  // Gera o corpo inteiro (o servidor real o envia em partes pelo socket)
+  virtual size_t render(String &body) { return 0; }
+
+  // Como no servidor real: _respond, chamado pelo send(), envia os headers e o
+  // corpo (aqui registrados na requisição); _ack vem a cada ACK ou poll da
+  // conexão, na tarefa do AsyncTCP
+  virtual void _respond(AsyncWebServerRequest *request);
+  virtual size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time) { return 0; }
+
+  int code;
+  std::vector<std::pair<String, String>, LibraryAllocator<std::pair<String, String>>> headers;
+};
+
+// Resposta com o corpo gerado pela subclasse em _fillBuffer, com os mesmos
+// campos da AsyncAbstractResponse do servidor real
+class AsyncAbstractResponse : public AsyncWebServerResponse
+{
+public:
+  AsyncAbstractResponse() : AsyncWebServerResponse(200, String()), _code(code) {}
+
+  virtual bool _sourceValid() const { return false; }
+  virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) { return 0; }
+
+  // Pede o corpo em segmentos TCP até _contentLength
+  size_t render(String &body) override;
+
+protected:
+  // Como no construtor da base, o tipo não é guardado
+  struct ContentType
+  {
+    ContentType &operator=(const String &) { return *this; }
+  };
+
+  int &_code;
+  ContentType _contentType;
+  size_t _contentLength = 0;
+};
+
+class AsyncWebServerRequest
+{
+public:
+  // Montagem da requisição pelos benchmarks
+  void setArg(const char *name, const char *value) { args.push_back(std::make_pair(String(name), String(value))); }
+  void setHeader(const char *name, const char *value) { headers.push_back(std::make_pair(String(name), String(value))); }
+  void clear();
+
+  bool hasArg(const char *name) const;
+  const String &arg(const char *name) const;
+  bool hasHeader(const char *name) const;
+  const String &header(const char *name) const;
+  const String &url() const { return path; }
+  WebRequestMethodComposite method() const { return HTTP_GET; }
+  size_t contentLength() const { return 0; }
+
+  void send(int code, const String &contentType = String(), const String &content = String());
+  void send(fs::FS &fs, const String &path, const String &contentType = String(), bool download = false);
+  void send(AsyncWebServerResponse *response);
+
+  AsyncWebServerResponse *beginResponse(int code, const String &contentType = String(), const String &content = String());
+  AsyncWebServerResponse *beginResponse(fs::FS &fs, const String &path, const String &contentType = String(),
+                                        bool download = false);
+  AsyncWebServerResponse *beginResponse(const String &contentType, size_t len, AwsResponseFiller callback);
+  AsyncWebServerResponse *beginChunkedResponse(const String &contentType, AwsResponseFiller callback);
+
+  void onDisconnect(ArDisconnectHandler handler) { disconnectHandler = handler; }
+
+  // Cliente fechou a conexão: o handler é chamado e a requisição destruída,
+  // com a resposta em andamento
+  void disconnect()
+  {
+    if (disconnectHandler)
+      disconnectHandler();
+    delete response;
+    response = nullptr;
+  }
+
+  // Poll da conexão (a cada ~500 ms no AsyncTCP): a resposta em andamento recebe _ack
+  void poll()
+  {
+    if (response != nullptr)
+      response->_ack(this, 0, 0);
+  }
+
+  // Última resposta enviada
+  int responseCode = 0;
+  size_t responseLength = 0;
+
+  // Cliente lento: com holdResponse a resposta não é lida no send() e fica em
+  // heldResponse até o teste ler o corpo (e a apagar)
+  bool holdResponse = false;
+  AsyncWebServerResponse *heldResponse = nullptr;
+
+  String path = "/";
+  void *_tempObject = nullptr;
+
+private:
+  std::vector<std::pair<String, String>> args;
+  std::vector<std::pair<String, String>> headers;
+  ArDisconnectHandler disconnectHandler;
+  AsyncWebServerResponse *response = nullptr; // Da requisição até a próxima (clear, send ou disconnect)
+};
+
+class AsyncWebHandler
+{
+public:
+  virtual ~AsyncWebHandler() {}
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler
+{
+};
+
+class AsyncEventSourceClient
+{
+public:
+  void send(const char *message, const char *event = NULL, uint32_t id = 0, uint32_t reconnect = 0) {}
+  void close() {}
+  bool connected() const { return true; }
+};
+
+class AsyncEventSource : public AsyncWebHandler
+{
+public:
+  AsyncEventSource(const String &url) {}
+  void onConnect(ArEventHandlerFunction callback) { connectHandler = callback; }
+  void send(const char *message, const char *event = NULL, uint32_t id = 0, uint32_t reconnect = 0) { sent++; }
+  size_t count() const { return 0; }
+
+  uint32_t sent = 0;
+
+private:
+  ArEventHandlerFunction connectHandler;
+};
+
+class AsyncWebServer
+{
+public:
+  AsyncWebServer(uint16_t port) {}
+  void begin() {}
+  void end() {}
+
+  AsyncCallbackWebHandler &on(const char *uri, ArRequestHandlerFunction onRequest) { return handler; }
+  AsyncCallbackWebHandler &on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest)
+  {
+    return handler;
+  }
+  AsyncCallbackWebHandler &on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                              ArUploadHandlerFunction onUpload)
+  {
+    return handler;
+  }
+  AsyncCallbackWebHandler &on(const char *uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                              ArUploadHandlerFunction onUpload, ArBodyHandlerFunction onBody)
+  {
+    return handler;
+  }
+  AsyncWebHandler &addHandler(AsyncWebHandler *h) { return *h; }
+  void onNotFound(ArRequestHandlerFunction fn) {}
+
+private:
+  AsyncCallbackWebHandler handler;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fs
+{
+  typedef std::vector<uint8_t> FileData;
+
+  // Arquivo em memória; a posição é própria de cada File aberto
+  class File : public Print
+  {
+  public:
+    File() {}
+    File(std::shared_ptr<FileData> data, bool append) : data(data), pos(append ? data->size() : 0) {}
+
+    operator bool() const { return data != nullptr; }
+    void close() { data.reset(); }
+    void flush() {}
+
+    size_t size() const { return data ? data->size() : 0; }
+    size_t position() const { return pos; }
+    bool seek(uint32_t offset)
+    {
+      if (!data || offset > data->size())
+        return false;
+      pos = offset;
+      return true;
+    }
+    int available() { return data ? (int)(data->size() - pos) : 0; }
+
+    int read()
+    {
+      uint8_t c;
+      return read(&c, 1) == 1 ? c : -1;
+    }
+    size_t read(uint8_t *buffer, size_t size)
+    {
+      if (!data || pos >= data->size())
+        return 0;
+      size_t n = data->size() - pos < size ? data->size() - pos : size;
+      memcpy(buffer, data->data() + pos, n);
+      pos += n;
+      return n;
+    }
+
+    using Print::write;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+      if (!data)
+        return 0;
+      if (pos + size > data->size())
+        data->resize(pos + size);
+      memcpy(data->data() + pos, buffer, size);
+      pos += size;
+      return size;
+    }
+
+  private:
+    std::shared_ptr<FileData> data;
+    size_t pos = 0;
+  };
+
+  class FS
+  {
+  public:
+    File open(const char *path, const char *mode = "r", bool create = false);
+    bool exists(const char *path) { return files.count(path) != 0; }
+    bool remove(const char *path) { return files.erase(path) != 0; }
+    bool rename(const char *from, const char *to);
+
+  protected:
+    std::map<std::string, std::shared_ptr<FileData>> files;
+  };
+}
+
+using fs::File;
+using fs::FS;
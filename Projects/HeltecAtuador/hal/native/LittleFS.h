@@ -0,0 +1,16 @@
+#pragma once
+
+#include <FS.h>
+
+class LittleFSFS : public fs::FS
+{
+public:
+  bool begin(bool formatOnFail = false) { return mounted = true; }
+  void end() { mounted = false; }
+  size_t totalBytes() { return 0xA8000; }
+  size_t usedBytes();
+
+  bool mounted = true; // Conferido pelos benchmarks
+};
+
+extern LittleFSFS LittleFS;
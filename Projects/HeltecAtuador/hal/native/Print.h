@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <WString.h>
+
+class Print;
+
+class Printable
+{
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--)
+      n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+
+  size_t print(const char *str) { return write(str); }
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n, int base = DEC) { return printNumber((long long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return printNumber((unsigned long long)n, base); }
+  size_t print(long n, int base = DEC) { return printNumber((long long)n, base); }
+  size_t print(unsigned long n, int base = DEC) { return printNumber((unsigned long long)n, base); }
+  size_t print(long long n, int base = DEC) { return printNumber(n, base); }
+  size_t print(unsigned long long n, int base = DEC) { return printNumber(n, base); }
+  size_t print(const Printable &x) { return x.printTo(*this); }
+
+  template <typename T>
+  size_t println(const T &value)
+  {
+    return print(value) + write("\r\n");
+  }
+  size_t println() { return write("\r\n"); }
+
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+  {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return len > 0 ? write((const uint8_t *)buffer, len < (int)sizeof(buffer) ? len : sizeof(buffer) - 1) : 0;
+  }
+
+private:
+  template <typename T>
+  size_t printNumber(T n, int base)
+  {
+    char buffer[24];
+    if (base == HEX)
+      snprintf(buffer, sizeof(buffer), "%llX", (unsigned long long)n);
+    else
+      snprintf(buffer, sizeof(buffer), (T)-1 < 0 ? "%lld" : "%llu", (long long)n);
+    return write(buffer);
+  }
+};
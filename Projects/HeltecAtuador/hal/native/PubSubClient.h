@@ -0,0 +1,79 @@
+#pragma once
+
+#include <Client.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define MQTT_CALLBACK_SIGNATURE std::function<void(char *, uint8_t *, unsigned int)> callback
+
+// Broker simulado: registra conexões, inscrições e publicações, e entrega
+// as mensagens injetadas pelo bench no próximo loop()
+class PubSubClient
+{
+public:
+  struct Message
+  {
+    std::string topic;
+    std::string payload;
+    bool retained;
+  };
+
+  PubSubClient(Client &client) {}
+
+  PubSubClient &setServer(const char *host, uint16_t port) { return *this; }
+  PubSubClient &setCallback(MQTT_CALLBACK_SIGNATURE)
+  {
+    this->callback = callback;
+    return *this;
+  }
+
+  bool connect(const char *id, const char *user, const char *pass, const char *willTopic, uint8_t willQos,
+               bool willRetain, const char *willMessage)
+  {
+    connectAttempts++;
+    online = acceptConnections;
+    return online;
+  }
+  void disconnect() { online = false; }
+  bool connected() { return online; }
+
+  bool publish(const char *topic, const char *payload, bool retained)
+  {
+    if (!online)
+      return false;
+    published.push_back({topic, payload, retained});
+    return true;
+  }
+  bool subscribe(const char *topic)
+  {
+    subscriptions.push_back(topic);
+    return online;
+  }
+
+  // Entrega todas as mensagens pendentes
+  bool loop()
+  {
+    for (size_t i = 0; i < inbox.size() && online; i++)
+    {
+      std::vector<char> topic(inbox[i].topic.begin(), inbox[i].topic.end());
+      topic.push_back('\0');
+      callback(topic.data(), (uint8_t *)&inbox[i].payload[0], inbox[i].payload.size());
+    }
+    inbox.clear();
+    return online;
+  }
+
+  // Controle do bench
+  void inject(const char *topic, const char *payload) { inbox.push_back({topic, payload, false}); }
+
+  bool acceptConnections = true;
+  int connectAttempts = 0;
+  std::vector<Message> published;
+  std::vector<std::string> subscriptions;
+
+private:
+  MQTT_CALLBACK_SIGNATURE;
+  bool online = false;
+  std::vector<Message> inbox;
+};
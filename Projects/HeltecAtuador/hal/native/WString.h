@@ -0,0 +1,123 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+
+// String do Arduino sobre std::string: mesmas alocações por concatenação
+class String
+{
+public:
+  String() {}
+  String(const char *cstr) : value(cstr ? cstr : "") {}
+  String(const String &other) = default;
+  String(char c) : value(1, c) {}
+  explicit String(int number, unsigned char base = DEC) : value(format(number, base)) {}
+  explicit String(unsigned int number, unsigned char base = DEC) : value(format(number, base)) {}
+  explicit String(long number, unsigned char base = DEC) : value(format(number, base)) {}
+  explicit String(unsigned long number, unsigned char base = DEC) : value(format(number, base)) {}
+
+  String &operator=(const String &other) = default;
+  String &operator=(const char *cstr)
+  {
+    value = cstr ? cstr : "";
+    return *this;
+  }
+
+  const char *c_str() const { return value.c_str(); }
+  unsigned int length() const { return value.length(); }
+  bool isEmpty() const { return value.empty(); }
+  bool reserve(unsigned int size)
+  {
+    value.reserve(size);
+    return true;
+  }
+  long toInt() const { return atol(value.c_str()); }
+  char operator[](unsigned int index) const { return index < value.size() ? value[index] : 0; }
+
+  bool concat(const String &other)
+  {
+    value += other.value;
+    return true;
+  }
+  bool concat(const char *cstr)
+  {
+    if (cstr)
+      value += cstr;
+    return cstr != NULL;
+  }
+  bool concat(char c)
+  {
+    value += c;
+    return true;
+  }
+  String &operator+=(const String &other)
+  {
+    concat(other);
+    return *this;
+  }
+  String &operator+=(const char *cstr)
+  {
+    concat(cstr);
+    return *this;
+  }
+  String &operator+=(char c)
+  {
+    concat(c);
+    return *this;
+  }
+
+  bool equals(const char *cstr) const { return value == (cstr ? cstr : ""); }
+  bool operator==(const String &other) const { return value == other.value; }
+  bool operator==(const char *cstr) const { return equals(cstr); }
+  bool operator!=(const String &other) const { return value != other.value; }
+  bool operator!=(const char *cstr) const { return !equals(cstr); }
+  bool startsWith(const char *prefix) const { return value.compare(0, strlen(prefix), prefix) == 0; }
+  bool endsWith(const char *suffix) const
+  {
+    size_t len = strlen(suffix);
+    return value.size() >= len && value.compare(value.size() - len, len, suffix) == 0;
+  }
+  int indexOf(char c) const
+  {
+    size_t pos = value.find(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+
+private:
+  template <typename T>
+  static std::string format(T number, unsigned char base)
+  {
+    char buffer[24];
+    if (base == HEX)
+      snprintf(buffer, sizeof(buffer), "%llx", (unsigned long long)number);
+    else
+      snprintf(buffer, sizeof(buffer), (T)-1 < 0 ? "%lld" : "%llu", (long long)number);
+    return buffer;
+  }
+
+  std::string value;
+};
+
+class StringSumHelper : public String
+{
+public:
+  StringSumHelper(const String &s) : String(s) {}
+  StringSumHelper(const char *p) : String(p) {}
+};
+
+inline StringSumHelper operator+(const StringSumHelper &lhs, const String &rhs)
+{
+  StringSumHelper result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+inline StringSumHelper operator+(const StringSumHelper &lhs, const char *rhs)
+{
+  StringSumHelper result(lhs);
+  result.concat(rhs);
+  return result;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Client.h>
+
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+typedef enum
+{
+  ARDUINO_EVENT_WIFI_STA_CONNECTED = 4,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED = 5,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP = 7,
+  ARDUINO_EVENT_WIFI_STA_LOST_IP = 8,
+  ARDUINO_EVENT_MAX = 40
+} arduino_event_id_t;
+
+typedef arduino_event_id_t WiFiEvent_t;
+typedef void (*WiFiEventCb)(arduino_event_id_t event);
+
+class IPAddress : public Printable
+{
+public:
+  IPAddress() {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : address(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+
+  operator uint32_t() const { return address; }
+  uint8_t operator[](int index) const { return address >> (index * 8); }
+  String toString() const;
+  size_t printTo(Print &p) const override;
+
+private:
+  uint32_t address = 0;
+};
+
+// Rede simulada: sempre conectada com valores fixos
+class WiFiClass
+{
+public:
+  int status() { return WL_CONNECTED; }
+  String SSID() { return String("bench-network"); }
+  IPAddress localIP() { return IPAddress(192, 168, 0, 50); }
+  IPAddress gatewayIP() { return IPAddress(192, 168, 0, 1); }
+  String macAddress() { return String("AA:BB:CC:DD:EE:FF"); }
+  int8_t RSSI() { return -55; }
+  bool mode(int m) { return true; }
+
+  // A rede simulada já está conectada: entrega o GOT_IP no registro
+  int onEvent(WiFiEventCb callback, arduino_event_id_t event = ARDUINO_EVENT_MAX)
+  {
+    callback(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    return 1;
+  }
+};
+
+extern WiFiClass WiFi;
+
+class WiFiClient : public Client
+{
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <WiFi.h>
+
+class WiFiManager
+{
+public:
+  bool autoConnect(const char *apName) { return true; }
+  void resetSettings() {}
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define I2C_BUFFER_LENGTH 128
+
+// Barramento I2C simulado: conta transações e bytes enviados
+class TwoWire
+{
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+  bool setClock(uint32_t frequency)
+  {
+    clock = frequency;
+    return true;
+  }
+
+  void beginTransmission(uint8_t address) { txLength = 0; }
+  uint8_t endTransmission(bool sendStop = true)
+  {
+    transactions++;
+    bytesSent += txLength;
+    return 0;
+  }
+  size_t write(uint8_t data)
+  {
+    if (txLength >= I2C_BUFFER_LENGTH)
+      return 0;
+    txLength++;
+    return 1;
+  }
+  size_t write(const uint8_t *data, size_t quantity)
+  {
+    size_t n = 0;
+    while (quantity-- && write(*data++))
+      n++;
+    return n;
+  }
+
+  uint8_t requestFrom(uint8_t address, size_t size) { return 0; }
+  int available() { return 0; }
+  int read() { return -1; }
+
+  void resetCounters()
+  {
+    transactions = 0;
+    bytesSent = 0;
+  }
+
+  uint32_t clock = 100000;
+  uint32_t transactions = 0;
+  uint32_t bytesSent = 0;
+
+private:
+  size_t txLength = 0;
+};
+
+extern TwoWire Wire;
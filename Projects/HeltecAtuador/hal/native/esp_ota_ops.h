@@ -0,0 +1,9 @@
+#pragma once
+
+#include <esp_partition.h>
+
+// A partição "ota_1" é sempre a inativa
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start);
+
+// Valida o cabeçalho da imagem (magic 0xE9) como o bootloader faria
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition);
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+// Um só fluxo de execução no host: o mutex nunca fica ocupado
+typedef void *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
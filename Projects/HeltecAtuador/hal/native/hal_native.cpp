@@ -0,0 +1,733 @@
+// Implementação dos stubs de hardware para o build nativo (env:native)
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include <ESPAsyncWebServer.h>
+#include <LittleFS.h>
+#include <WiFi.h>
+#include <Wire.h>
+#include <soc/gpio_struct.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
+#include <chrono>
+
+HardwareSerial Serial;
+EspClass ESP;
+TwoWire Wire;
+WiFiClass WiFi;
+LittleFSFS LittleFS;
+gpio_dev_t GPIO;
+
+static const auto startTime = std::chrono::steady_clock::now();
+static uint8_t pinLevels[64];
+
+unsigned long millis()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(uint32_t ms) {}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (mode == INPUT_PULLUP)
+    pinLevels[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) { pinLevels[pin] = val; }
+int digitalRead(uint8_t pin) { return pinLevels[pin]; }
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {}
+
+void configTzTime(const char *tz, const char *server1, const char *server2, const char *server3)
+{
+  setenv("TZ", tz, 1);
+  tzset();
+}
+
+void EspClass::restart()
+{
+  fprintf(stderr, "ESP.restart() chamado\n");
+  exit(1);
+}
+
+// --- FreeRTOS ---
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stackDepth, void *parameters,
+                                   UBaseType_t priority, TaskHandle_t *createdTask, BaseType_t coreId)
+{
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {}
+void vTaskDelay(TickType_t ticks) {}
+void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t increment) { *previousWakeTime += increment; }
+TickType_t xTaskGetTickCount() { return millis(); }
+TaskHandle_t xTaskGetCurrentTaskHandle() { return NULL; }
+TaskHandle_t xTaskGetHandle(const char *name) { return NULL; }
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) { return 0; }
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) { return pdPASS; }
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *woken)
+{
+  return pdPASS;
+}
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t *value, TickType_t ticks)
+{
+  return pdFALSE;
+}
+BaseType_t xTaskNotifyGive(TaskHandle_t task) { return pdPASS; }
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) { return 0; }
+
+uint32_t esp_random()
+{
+  static uint32_t state = 0x9E3779B9;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+  static int dummy;
+  return &dummy;
+}
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) { return pdTRUE; }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) { return pdTRUE; }
+
+// --- Adafruit_GFX ---
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  for (int16_t i = 0; i < w; i++)
+    drawPixel(x + i, y, color);
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  for (int16_t i = 0; i < h; i++)
+    drawPixel(x, y + i, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+  if (y0 == y1)
+  {
+    if (x1 < x0)
+    {
+      int16_t t = x0;
+      x0 = x1;
+      x1 = t;
+    }
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    return;
+  }
+
+  int16_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int16_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int16_t err = dx + dy;
+  for (;;)
+  {
+    drawPixel(x0, y0, color);
+    if (x0 == x1 && y0 == y1)
+      break;
+    int16_t e2 = 2 * err;
+    if (e2 >= dy)
+    {
+      err += dy;
+      x0 += sx;
+    }
+    if (e2 <= dx)
+    {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  for (int16_t i = x; i < x + w; i++)
+    drawFastVLine(i, y, h, color);
+}
+
+// Mesmo algoritmo do Adafruit_GFX::drawBitmap: bitmap row-major, pixel a pixel
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+{
+  int16_t byteWidth = (w + 7) / 8;
+  uint8_t b = 0;
+
+  for (int16_t j = 0; j < h; j++, y++)
+  {
+    for (int16_t i = 0; i < w; i++)
+    {
+      if (i & 7)
+        b <<= 1;
+      else
+        b = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+      if (b & 0x80)
+        drawPixel(x + i, y, color);
+    }
+  }
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size)
+{
+  if (x >= _width || y >= _height || x + 6 * size - 1 < 0 || y + 8 * size - 1 < 0)
+    return;
+
+  for (int8_t i = 0; i < 5; i++)
+  {
+    uint8_t line = (uint8_t)(c * 37 + i * 11) & 0x7F; // Glifo sintético de 5x7
+    for (int8_t j = 0; j < 8; j++, line >>= 1)
+    {
+      if (line & 1)
+        drawPixel(x + i, y + j, color);
+      else if (bg != color)
+        drawPixel(x + i, y + j, bg);
+    }
+  }
+  if (bg != color)
+    drawFastVLine(x + 5, y, 8, bg);
+}
+
+size_t Adafruit_GFX::write(uint8_t c)
+{
+  if (c == '\n')
+  {
+    cursor_x = 0;
+    cursor_y += textsize * 8;
+  }
+  else if (c != '\r')
+  {
+    if (wrap && cursor_x + textsize * 6 > _width)
+    {
+      cursor_x = 0;
+      cursor_y += textsize * 8;
+    }
+    drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+    cursor_x += textsize * 6;
+  }
+  return 1;
+}
+
+// --- Adafruit_SSD1306 ---
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi, int8_t rst_pin, uint32_t clkDuring,
+                                   uint32_t clkAfter)
+    : Adafruit_GFX(w, h), wire(twi)
+{
+  memset(buffer, 0, sizeof(buffer));
+}
+
+bool Adafruit_SSD1306::begin(uint8_t switchvcc, uint8_t i2caddr, bool reset, bool periphBegin)
+{
+  address = i2caddr;
+  clearDisplay();
+  return true;
+}
+
+void Adafruit_SSD1306::display()
+{
+  static const uint8_t commands[] = {0x00, SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0, 127};
+  wire->beginTransmission(address);
+  wire->write(commands, sizeof(commands));
+  wire->endTransmission();
+
+  const uint8_t *data = buffer;
+  size_t remaining = sizeof(buffer);
+  while (remaining > 0)
+  {
+    size_t chunk = remaining < I2C_BUFFER_LENGTH - 1 ? remaining : I2C_BUFFER_LENGTH - 1;
+    wire->beginTransmission(address);
+    wire->write((uint8_t)0x40);
+    wire->write(data, chunk);
+    wire->endTransmission();
+    data += chunk;
+    remaining -= chunk;
+  }
+}
+
+void Adafruit_SSD1306::clearDisplay()
+{
+  memset(buffer, 0, sizeof(buffer));
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  if (x < 0 || x >= width() || y < 0 || y >= height())
+    return;
+
+  switch (color)
+  {
+  case SSD1306_WHITE:
+    buffer[x + (y / 8) * width()] |= (1 << (y & 7));
+    break;
+  case SSD1306_BLACK:
+    buffer[x + (y / 8) * width()] &= ~(1 << (y & 7));
+    break;
+  case SSD1306_INVERSE:
+    buffer[x + (y / 8) * width()] ^= (1 << (y & 7));
+    break;
+  }
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y)
+{
+  if (x < 0 || x >= width() || y < 0 || y >= height())
+    return false;
+  return buffer[x + (y / 8) * width()] & (1 << (y & 7));
+}
+
+// --- WiFi ---
+
+String IPAddress::toString() const
+{
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+  return String(buffer);
+}
+
+size_t IPAddress::printTo(Print &p) const
+{
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+  return p.print(buffer);
+}
+
+// --- FS ---
+
+fs::File fs::FS::open(const char *path, const char *mode, bool create)
+{
+  auto it = files.find(path);
+
+  if (mode[0] == 'r')
+    return it == files.end() ? File() : File(it->second, false);
+
+  if (it == files.end() || mode[0] == 'w')
+    it = files.insert_or_assign(path, std::make_shared<FileData>()).first;
+
+  return File(it->second, mode[0] == 'a');
+}
+
+bool fs::FS::rename(const char *from, const char *to)
+{
+  auto it = files.find(from);
+  if (it == files.end())
+    return false;
+
+  files[to] = it->second;
+  files.erase(from);
+  return true;
+}
+
+size_t LittleFSFS::usedBytes()
+{
+  size_t used = 0;
+  for (auto &file : files)
+    used += file.second->size();
+  return used;
+}
+
+// --- ESPAsyncWebServer ---
+
+#ifdef __GLIBC__
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void __libc_free(void *p);
+#endif
+
+void *libraryMalloc(size_t size)
+{
+#ifdef __GLIBC__
+  return __libc_malloc(size);
+#else
+  return malloc(size);
+#endif
+}
+
+void libraryFree(void *p)
+{
+#ifdef __GLIBC__
+  __libc_free(p);
+#else
+  free(p);
+#endif
+}
+
+namespace
+{
+  class BasicResponse : public AsyncWebServerResponse
+  {
+  public:
+    BasicResponse(int code, const String &contentType, const String &content)
+        : AsyncWebServerResponse(code, contentType), content(content) {}
+    size_t render(String &body) override
+    {
+      body = content;
+      return content.length();
+    }
+
+  private:
+    String content;
+  };
+
+  class FileResponse : public AsyncWebServerResponse
+  {
+  public:
+    FileResponse(File file, const String &contentType) : AsyncWebServerResponse(200, contentType), file(file) {}
+    size_t render(String &body) override
+    {
+      size_t total = 0;
+      uint8_t buffer[512];
+      size_t len;
+      while ((len = file.read(buffer, sizeof(buffer))) > 0)
+        total += len;
+      return total;
+    }
+
+  private:
+    File file;
+  };
+
+  class CallbackResponse : public AsyncWebServerResponse
+  {
+  public:
+    CallbackResponse(const String &contentType, size_t length, AwsResponseFiller filler)
+        : AsyncWebServerResponse(200, contentType), length(length), filler(filler) {}
+    size_t render(String &body) override
+    {
+      size_t total = 0;
+      uint8_t buffer[1436];
+      while (total < length)
+      {
+        size_t len = filler(buffer, length - total < sizeof(buffer) ? length - total : sizeof(buffer), total);
+        if (len == 0)
+          break;
+        total += len;
+      }
+      return total;
+    }
+
+  private:
+    size_t length;
+    AwsResponseFiller filler;
+  };
+
+  class ChunkedResponse : public AsyncWebServerResponse
+  {
+  public:
+    ChunkedResponse(const String &contentType, AwsResponseFiller filler)
+        : AsyncWebServerResponse(200, contentType), filler(filler) {}
+    size_t render(String &body) override
+    {
+      size_t total = 0;
+      uint8_t buffer[1436]; // Um segmento TCP, como no AsyncTCP
+      size_t len;
+      while ((len = filler(buffer, sizeof(buffer), total)) > 0)
+        total += len;
+      return total;
+    }
+
+  private:
+    AwsResponseFiller filler;
+  };
+
+  const String emptyString;
+}
+
+size_t AsyncAbstractResponse::render(String &body)
+{
+  size_t total = 0;
+  uint8_t buffer[1436];
+  while (total < _contentLength)
+  {
+    size_t len = _fillBuffer(buffer, _contentLength - total < sizeof(buffer) ? _contentLength - total : sizeof(buffer));
+    if (len == 0)
+      break;
+    total += len;
+  }
+  return total;
+}
+
+void AsyncWebServerResponse::_respond(AsyncWebServerRequest *request)
+{
+  String body;
+  request->responseCode = code;
+  request->responseLength = render(body);
+}
+
+void AsyncWebServerRequest::clear()
+{
+  args.clear();
+  headers.clear();
+  delete response;
+  response = nullptr;
+  responseCode = 0;
+  responseLength = 0;
+}
+
+bool AsyncWebServerRequest::hasArg(const char *name) const
+{
+  for (auto &arg : args)
+    if (arg.first == name)
+      return true;
+  return false;
+}
+
+const String &AsyncWebServerRequest::arg(const char *name) const
+{
+  for (auto &arg : args)
+    if (arg.first == name)
+      return arg.second;
+  return emptyString;
+}
+
+bool AsyncWebServerRequest::hasHeader(const char *name) const
+{
+  for (auto &header : headers)
+    if (header.first == name)
+      return true;
+  return false;
+}
+
+const String &AsyncWebServerRequest::header(const char *name) const
+{
+  for (auto &header : headers)
+    if (header.first == name)
+      return header.second;
+  return emptyString;
+}
+
+void AsyncWebServerRequest::send(int code, const String &contentType, const String &content)
+{
+  responseCode = code;
+  responseLength = content.length();
+}
+
+void AsyncWebServerRequest::send(fs::FS &fs, const String &path, const String &contentType, bool download)
+{
+  send(beginResponse(fs, path, contentType, download));
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse *response)
+{
+  if (holdResponse)
+  {
+    responseCode = response->code;
+    delete heldResponse;
+    heldResponse = response;
+    return;
+  }
+
+  delete this->response;
+  this->response = response;
+  response->_respond(this);
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(int code, const String &contentType, const String &content)
+{
+  return new BasicResponse(code, contentType, content);
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(fs::FS &fs, const String &path,
+                                                             const String &contentType, bool download)
+{
+  File file = fs.open(path.c_str(), "r");
+  if (!file)
+    return new BasicResponse(404, String(), String());
+  return new FileResponse(file, contentType);
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(const String &contentType, size_t len,
+                                                             AwsResponseFiller callback)
+{
+  return new CallbackResponse(contentType, len, callback);
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginChunkedResponse(const String &contentType,
+                                                                    AwsResponseFiller callback)
+{
+  return new ChunkedResponse(contentType, callback);
+}
+
+// --- Partições (partitions_custom.csv) ---
+
+static esp_partition_t partitionTable[] = {
+    {ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, 0x10000, 0x1A0000, "ota_0"},
+    {ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, 0x1B0000, 0x1A0000, "ota_1"},
+    {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, 0x358000, 0xA8000, "data"},
+};
+static uint8_t flash[0x400000];
+uint32_t espPartitionErases = 0;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+  for (const esp_partition_t &partition : partitionTable)
+  {
+    if (partition.type == type && (subtype == ESP_PARTITION_SUBTYPE_ANY || partition.subtype == subtype) &&
+        (label == NULL || strcmp(label, partition.label) == 0))
+      return &partition;
+  }
+  return NULL;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size)
+{
+  if (offset % 4096 != 0 || size % 4096 != 0 || offset + size > partition->size)
+    return ESP_ERR_INVALID_ARG;
+  memset(flash + partition->address + offset, 0xFF, size);
+  espPartitionErases += size / 4096;
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t offset, const void *src, size_t size)
+{
+  if (offset + size > partition->size)
+    return ESP_ERR_INVALID_SIZE;
+  const uint8_t *bytes = (const uint8_t *)src;
+  for (size_t i = 0; i < size; i++)
+    flash[partition->address + offset + i] &= bytes[i];
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t offset, void *dst, size_t size)
+{
+  if (offset + size > partition->size)
+    return ESP_ERR_INVALID_SIZE;
+  memcpy(dst, flash + partition->address + offset, size);
+  return ESP_OK;
+}
+
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start)
+{
+  return &partitionTable[1];
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition)
+{
+  return flash[partition->address] == 0xE9 ? ESP_OK : ESP_ERR_OTA_VALIDATE_FAILED;
+}
+
+// --- SHA-256 (FIPS 180-4) ---
+
+static const uint32_t sha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static uint32_t rotr(uint32_t x, int n)
+{
+  return (x >> n) | (x << (32 - n));
+}
+
+static void sha256Block(mbedtls_sha256_context *ctx, const uint8_t *block)
+{
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++)
+    w[i] = (uint32_t)block[i * 4] << 24 | block[i * 4 + 1] << 16 | block[i * 4 + 2] << 8 | block[i * 4 + 3];
+  for (int i = 16; i < 64; i++)
+  {
+    uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t v[8];
+  memcpy(v, ctx->state, sizeof(v));
+  for (int i = 0; i < 64; i++)
+  {
+    uint32_t t1 = v[7] + (rotr(v[4], 6) ^ rotr(v[4], 11) ^ rotr(v[4], 25)) + ((v[4] & v[5]) ^ (~v[4] & v[6])) +
+                  sha256K[i] + w[i];
+    uint32_t t2 = (rotr(v[0], 2) ^ rotr(v[0], 13) ^ rotr(v[0], 22)) + ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+    memmove(v + 1, v, 7 * sizeof(uint32_t));
+    v[4] += t1;
+    v[0] = t1 + t2;
+  }
+  for (int i = 0; i < 8; i++)
+    ctx->state[i] += v[i];
+}
+
+void mbedtls_sha256_init(mbedtls_sha256_context *ctx)
+{
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_sha256_free(mbedtls_sha256_context *ctx)
+{
+}
+
+void mbedtls_sha256_clone(mbedtls_sha256_context *dst, const mbedtls_sha256_context *src)
+{
+  *dst = *src;
+}
+
+int mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224)
+{
+  static const uint32_t initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                      0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  memcpy(ctx->state, initial, sizeof(initial));
+  ctx->length = 0;
+  ctx->used = 0;
+  return 0;
+}
+
+int mbedtls_sha256_update(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen)
+{
+  ctx->length += ilen;
+  while (ilen > 0)
+  {
+    size_t chunk = 64 - ctx->used < ilen ? 64 - ctx->used : ilen;
+    memcpy(ctx->block + ctx->used, input, chunk);
+    ctx->used += chunk;
+    input += chunk;
+    ilen -= chunk;
+    if (ctx->used == 64)
+    {
+      sha256Block(ctx, ctx->block);
+      ctx->used = 0;
+    }
+  }
+  return 0;
+}
+
+int mbedtls_sha256_finish(mbedtls_sha256_context *ctx, unsigned char output[32])
+{
+  uint64_t bits = ctx->length * 8;
+  uint8_t pad = 0x80;
+  mbedtls_sha256_update(ctx, &pad, 1);
+  pad = 0;
+  while (ctx->used != 56)
+    mbedtls_sha256_update(ctx, &pad, 1);
+
+  uint8_t length[8];
+  for (int i = 0; i < 8; i++)
+    length[i] = bits >> (56 - i * 8);
+  mbedtls_sha256_update(ctx, length, 8);
+
+  for (int i = 0; i < 8; i++)
+  {
+    output[i * 4] = ctx->state[i] >> 24;
+    output[i * 4 + 1] = ctx->state[i] >> 16;
+    output[i * 4 + 2] = ctx->state[i] >> 8;
+    output[i * 4 + 3] = ctx->state[i];
+  }
+  return 0;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef struct
+{
+  volatile uint32_t out;
+  volatile uint32_t out_w1ts;
+  volatile uint32_t out_w1tc;
+} gpio_dev_t;
+
+extern gpio_dev_t GPIO;
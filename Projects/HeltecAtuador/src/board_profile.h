@@ -0,0 +1,22 @@
+#pragma once
+
+// Perfil da placa, escolhido por build flag (platformio.ini):
+//   -DBOARD_PROFILE_HELTEC_V3       7 relés nos GPIOs 1 a 7 (padrão)
+//   -DBOARD_PROFILE_MCP23017_16     16 relés num MCP23017 (0x20)
+//   -DBOARD_PROFILE_MCP23017_32     32 relés em dois MCP23017 (0x20 e 0x21)
+//   -DBOARD_PROFILE_PCF8575_16      16 relés num PCF8575 (0x20), acionados em nível baixo
+// Os expansores ficam no mesmo barramento I2C do display.
+
+#include <Wire.h>
+#include <relay_outputs.h>
+
+#if defined(BOARD_PROFILE_MCP23017_16)
+typedef Mcp23017RelayOutputs<TwoWire, 0x20, 1> RelayOutputs;
+#elif defined(BOARD_PROFILE_MCP23017_32)
+typedef Mcp23017RelayOutputs<TwoWire, 0x20, 2> RelayOutputs;
+#elif defined(BOARD_PROFILE_PCF8575_16)
+typedef Pcf8575RelayOutputs<TwoWire, 0x20, 1, true> RelayOutputs;
+#else
+#define BOARD_PROFILE_HELTEC_V3
+typedef GpioRelayOutputs<1, 2, 3, 4, 5, 6, 7> RelayOutputs;
+#endif
@@ -0,0 +1,91 @@
+#include <button_input.h>
+
+ButtonInput::ButtonInput(uint32_t debounceMs, uint32_t longPressMs, uint32_t doublePressMs)
+    : debounceMs(debounceMs), longPressMs(longPressMs), doublePressMs(doublePressMs)
+{
+}
+
+ButtonEvent ButtonInput::feed(const ButtonEdge &edge)
+{
+  rawPressed = edge.pressed;
+  lastEdgeMs = edge.timeMs;
+
+  // Bordas dentro da janela de debounce ficam pendentes até o poll()
+  if (edge.pressed != stablePressed && edge.timeMs - lastChangeMs >= debounceMs)
+    return accept(edge.pressed, edge.timeMs);
+
+  return ButtonEvent::None;
+}
+
+ButtonEvent ButtonInput::poll(uint32_t nowMs)
+{
+  if (rawPressed != stablePressed && nowMs - lastEdgeMs >= debounceMs)
+  {
+    ButtonEvent event = accept(rawPressed, lastEdgeMs);
+    if (event != ButtonEvent::None)
+      return event;
+  }
+
+  if (stablePressed && !longPressFired && nowMs - pressStartMs >= longPressMs)
+  {
+    longPressFired = true;
+    return ButtonEvent::LongPress;
+  }
+
+  return ButtonEvent::None;
+}
+
+uint32_t ButtonInput::nextDeadline(uint32_t nowMs) const
+{
+  uint32_t deadline = NO_DEADLINE;
+
+  if (rawPressed != stablePressed)
+  {
+    uint32_t elapsed = nowMs - lastEdgeMs;
+    deadline = elapsed < debounceMs ? debounceMs - elapsed : 0;
+  }
+
+  if (stablePressed && !longPressFired)
+  {
+    uint32_t elapsed = nowMs - pressStartMs;
+    uint32_t remaining = elapsed < longPressMs ? longPressMs - elapsed : 0;
+    if (remaining < deadline)
+      deadline = remaining;
+  }
+
+  return deadline;
+}
+
+void ButtonInput::resync(bool pressed, uint32_t nowMs)
+{
+  rawPressed = stablePressed = pressed;
+  lastEdgeMs = lastChangeMs = pressStartMs = nowMs;
+  longPressFired = pressed; // A soltura dele também não gera curto
+  lastShortValid = false;
+}
+
+ButtonEvent ButtonInput::accept(bool pressed, uint32_t timeMs)
+{
+  stablePressed = pressed;
+  lastChangeMs = timeMs;
+
+  if (pressed)
+  {
+    pressStartMs = timeMs;
+    longPressFired = false;
+    return ButtonEvent::None;
+  }
+
+  if (longPressFired || timeMs - pressStartMs < debounceMs)
+    return ButtonEvent::None;
+
+  if (lastShortValid && timeMs - lastShortMs <= doublePressMs)
+  {
+    lastShortValid = false;
+    return ButtonEvent::DoublePress;
+  }
+
+  lastShortValid = true;
+  lastShortMs = timeMs;
+  return ButtonEvent::ShortPress;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+// Borda do botão registrada pela ISR
+struct ButtonEdge
+{
+  uint32_t timeMs;
+  bool pressed;
+  uint32_t isrUs; // micros() na ISR, só para a métrica de latência
+};
+
+enum class ButtonEvent : uint8_t
+{
+  None,
+  ShortPress,
+  LongPress,
+  DoublePress
+};
+
+// Máquina de estados do botão: recebe bordas com timestamp e gera eventos de
+// pressionamento curto, longo e duplo. Não depende do hardware, então pode ser
+// alimentada com timestamps sintéticos.
+class ButtonInput
+{
+public:
+  static const uint32_t NO_DEADLINE = UINT32_MAX;
+
+  ButtonInput(uint32_t debounceMs, uint32_t longPressMs, uint32_t doublePressMs);
+
+  // Processa uma borda; retorna o evento gerado por ela, se houver
+  ButtonEvent feed(const ButtonEdge &edge);
+
+  // Processa eventos que dependem só do tempo (debounce pendente, pressionamento longo)
+  ButtonEvent poll(uint32_t nowMs);
+
+  // Milissegundos até o próximo poll necessário, ou NO_DEADLINE
+  uint32_t nextDeadline(uint32_t nowMs) const;
+
+  // Bordas perdidas (fila da ISR cheia): adota o nível lido do pino sem gerar
+  // evento. Um pressionamento em curso não vira longo nem curto.
+  void resync(bool pressed, uint32_t nowMs);
+
+  bool isPressed() const { return stablePressed; }
+
+private:
+  ButtonEvent accept(bool pressed, uint32_t timeMs);
+
+  uint32_t debounceMs;
+  uint32_t longPressMs;
+  uint32_t doublePressMs;
+
+  bool rawPressed = false;
+  bool stablePressed = false;
+  bool longPressFired = false;
+  bool lastShortValid = false;
+  uint32_t lastEdgeMs = 0;
+  uint32_t lastChangeMs = 0;
+  uint32_t pressStartMs = 0;
+  uint32_t lastShortMs = 0;
+};
@@ -0,0 +1,76 @@
+#include <display_flush.h>
+
+#if defined(I2C_BUFFER_LENGTH)
+#define FLUSH_WIRE_MAX I2C_BUFFER_LENGTH
+#else
+#define FLUSH_WIRE_MAX 32
+#endif
+
+DisplayFlush::DisplayFlush(Adafruit_SSD1306 &display, TwoWire &wire, uint8_t address)
+    : display(display), wire(wire), address(address)
+{
+}
+
+void DisplayFlush::invalidate()
+{
+  fullRefresh = true;
+}
+
+size_t DisplayFlush::flush()
+{
+  const uint8_t *buffer = display.getBuffer();
+  size_t sent = 0;
+
+  for (uint8_t page = 0; page < PAGES; page++)
+  {
+    const uint8_t *current = buffer + page * COLUMNS;
+    uint8_t *previous = shadow + page * COLUMNS;
+
+    int first = 0;
+    int last = COLUMNS - 1;
+
+    if (!fullRefresh)
+    {
+      if (memcmp(current, previous, COLUMNS) == 0)
+        continue;
+
+      while (current[first] == previous[first])
+        first++;
+      while (current[last] == previous[last])
+        last--;
+    }
+
+    sendPageRange(page, first, last, current + first);
+    memcpy(previous + first, current + first, last - first + 1);
+    sent += last - first + 1;
+  }
+
+  fullRefresh = false;
+  lastBytes = sent;
+  return sent;
+}
+
+void DisplayFlush::sendPageRange(uint8_t page, uint8_t firstColumn, uint8_t lastColumn, const uint8_t *data)
+{
+  wire.beginTransmission(address);
+  wire.write((uint8_t)0x00); // Co = 0, D/C = 0: sequência de comandos
+  wire.write((uint8_t)SSD1306_COLUMNADDR);
+  wire.write(firstColumn);
+  wire.write(lastColumn);
+  wire.write((uint8_t)SSD1306_PAGEADDR);
+  wire.write(page);
+  wire.write(page);
+  wire.endTransmission();
+
+  size_t remaining = lastColumn - firstColumn + 1;
+  while (remaining > 0)
+  {
+    size_t chunk = remaining < FLUSH_WIRE_MAX - 1 ? remaining : FLUSH_WIRE_MAX - 1;
+    wire.beginTransmission(address);
+    wire.write((uint8_t)0x40); // D/C = 1: dados para a GDDRAM
+    wire.write(data, chunk);
+    wire.endTransmission();
+    data += chunk;
+    remaining -= chunk;
+  }
+}
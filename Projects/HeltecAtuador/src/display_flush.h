@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+
+// Envia ao SSD1306 somente as faixas de colunas alteradas em cada página
+// desde o último quadro, em vez do framebuffer inteiro.
+class DisplayFlush
+{
+public:
+  static const uint8_t PAGES = 8;
+  static const uint8_t COLUMNS = 128;
+
+  DisplayFlush(Adafruit_SSD1306 &display, TwoWire &wire, uint8_t address);
+
+  // Força o envio completo no próximo flush (ex.: após display.begin())
+  void invalidate();
+
+  // Envia as diferenças e retorna a quantidade de bytes de dados transmitidos
+  size_t flush();
+
+  size_t lastFlushBytes() const { return lastBytes; }
+
+private:
+  void sendPageRange(uint8_t page, uint8_t firstColumn, uint8_t lastColumn, const uint8_t *data);
+
+  Adafruit_SSD1306 &display;
+  TwoWire &wire;
+  uint8_t address;
+  bool fullRefresh = true;
+  size_t lastBytes = 0;
+  uint8_t shadow[PAGES * COLUMNS];
+};
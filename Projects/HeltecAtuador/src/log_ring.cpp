@@ -0,0 +1,54 @@
+#include <log_ring.h>
+#include <stdio.h>
+#include <string.h>
+
+const LogEntry &LogRing::append(LogLevel level, uint32_t timestampMs, const char *format, va_list args)
+{
+  uint32_t seq = head.fetch_add(1, std::memory_order_acq_rel);
+  Slot &slot = slots[seq & (CAPACITY - 1)];
+
+  slot.published.store(0, std::memory_order_release);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.entry.seq = seq;
+  slot.entry.timestampMs = timestampMs;
+  slot.entry.level = level;
+  vsnprintf(slot.entry.text, sizeof(slot.entry.text), format, args);
+
+  slot.published.store(seq + 1, std::memory_order_release);
+  return slot.entry;
+}
+
+bool LogRing::read(uint32_t seq, LogEntry &entry) const
+{
+  const Slot &slot = slots[seq & (CAPACITY - 1)];
+
+  if (slot.published.load(std::memory_order_acquire) != seq + 1)
+    return false;
+
+  memcpy(&entry, &slot.entry, sizeof(entry));
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  return slot.published.load(std::memory_order_relaxed) == seq + 1;
+}
+
+uint32_t LogRing::oldestSeq() const
+{
+  uint32_t next = nextSeq();
+  return next > CAPACITY ? next - CAPACITY : 0;
+}
+
+const char *LogRing::levelName(LogLevel level)
+{
+  switch (level)
+  {
+  case LogLevel::Debug:
+    return "DEBUG";
+  case LogLevel::Info:
+    return "INFO";
+  case LogLevel::Warn:
+    return "WARN";
+  default:
+    return "ERROR";
+  }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#ifndef LOG_RING_CAPACITY
+#define LOG_RING_CAPACITY 32 // Potência de 2
+#endif
+#ifndef LOG_TEXT_SIZE
+#define LOG_TEXT_SIZE 48
+#endif
+
+enum class LogLevel : uint8_t
+{
+  Debug,
+  Info,
+  Warn,
+  Error
+};
+
+struct LogEntry
+{
+  uint32_t seq;
+  uint32_t timestampMs;
+  LogLevel level;
+  char text[LOG_TEXT_SIZE];
+};
+
+// Buffer circular de logs pré-alocado, sem uso de heap. Vários produtores
+// reservam slots com fetch_add e formatam direto no slot; leitores copiam a
+// entrada e descartam cópias sobrescritas durante a leitura (estilo seqlock).
+class LogRing
+{
+public:
+  static const uint32_t CAPACITY = LOG_RING_CAPACITY;
+
+  // Formata a mensagem no próximo slot e retorna a entrada gravada
+  const LogEntry &append(LogLevel level, uint32_t timestampMs, const char *format, va_list args);
+
+  // Copia a entrada "seq"; falso se ainda não existe ou já foi sobrescrita
+  bool read(uint32_t seq, LogEntry &entry) const;
+
+  // Sequência que a próxima mensagem receberá
+  uint32_t nextSeq() const { return head.load(std::memory_order_acquire); }
+
+  // Sequência mais antiga ainda disponível
+  uint32_t oldestSeq() const;
+
+  static const char *levelName(LogLevel level);
+
+private:
+  struct Slot
+  {
+    std::atomic<uint32_t> published{0}; // seq + 1 quando completo, 0 durante a escrita
+    LogEntry entry;
+  };
+
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "LOG_RING_CAPACITY deve ser potencia de 2");
+
+  Slot slots[CAPACITY];
+  std::atomic<uint32_t> head{0};
+};
@@ -4,11 +4,30 @@
 #include <Adafruit_SSD1306.h>
 #include <WiFi.h>
 #include <WiFiManager.h>
-#include <WebServer.h>
-#include <images.h>
+#include <ESPAsyncWebServer.h>
+#include <images_paged.h>
+#include <display_flush.h>
+#include <button_input.h>
+#include <spsc_ring.h>
+#include <relay_state.h>
+#include <board_profile.h>
+#include <log_ring.h>
+#include <relay_journal.h>
+#include <metrics.h>
+#include <relay_scheduler.h>
+#include <schedule_store.h>
+#include <ui_widgets.h>
+#include <network_cache.h>
+#include <mqtt_link.h>
+#include <ota_stream.h>
+#include <udp_control.h>
+#include <relay_actuator.h>
+#include <AsyncUDP.h>
 #include <FS.h>
 #include <LittleFS.h>
-#include <ArduinoJson.h>
+#include <atomic>
+#include <type_traits>
+#include <time.h>
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
@@ -18,65 +37,446 @@
 #define SCREEN_ADDRESS 0x3C
 #define I2C_FREQUENCY 500000
 #define BUTTON_PIN 0
-#define LOG_MAX_LINES 8
+#define LOG_SCREEN_LINES 6
+#define BOOT_MAX_PHASES 8
+
+// Eventos que acordam a tarefa do display
+#define DISPLAY_EVENT_RELAY (1 << 0)
+#define DISPLAY_EVENT_SCREEN (1 << 1)
+#define DISPLAY_EVENT_LOG (1 << 2)
+#define DISPLAY_EVENT_BUTTON (1 << 3)
+#define DISPLAY_EVENT_TICK (1 << 4)
+#define DISPLAY_EVENT_NETWORK (1 << 5)
+
+// Long-poll do /status: esperas simultâneas e prazo máximo de "wait"
+#ifndef STATUS_POLL_MAX_WAITERS
+#define STATUS_POLL_MAX_WAITERS 8
+#endif
+#define STATUS_POLL_MAX_MS 30000
+
+// Cliente MQTT opcional: -DMQTT_BROKER=\"192.168.0.10\" no platformio.ini; vazio desliga
+#ifndef MQTT_BROKER
+#define MQTT_BROKER ""
+#endif
+#ifndef MQTT_PORT
+#define MQTT_PORT 1883
+#endif
+#ifndef MQTT_USER
+#define MQTT_USER NULL
+#endif
+#ifndef MQTT_PASSWORD
+#define MQTT_PASSWORD NULL
+#endif
 
 // Configuração de tempos
 const unsigned long LONG_PRESS_DURATION = 2000;
 const unsigned long DEBOUNCE_DELAY = 50;
-const unsigned long SCREEN_UPDATE_DELAY = 200;
+const unsigned long DOUBLE_PRESS_WINDOW = 400;
+const unsigned long INFO_SCREEN_UPDATE_DELAY = 1000; // Apenas telas de WiFi e ESP
+const unsigned long SPLASH_DURATION = 2000;
+const unsigned long JOURNAL_COALESCE_DELAY = 2000;   // Silêncio antes de gravar uma rajada
+const unsigned long JOURNAL_MAX_DELAY = 10000;       // Atraso máximo de gravação sob mudanças contínuas
+
+const int RELAY_COUNT = RelayOutputs::COUNT; // Definido pelo perfil da placa (board_profile.h)
+const uint32_t ALL_RELAYS_MASK = RELAY_COUNT >= 32 ? UINT32_MAX : (1u << RELAY_COUNT) - 1;
+const String JSON_CONTENT_TYPE = "application/json"; // Alocada uma vez no boot
 
-const int RELAY_COUNT = 7;
-const int relayPins[RELAY_COUNT] = {1, 2, 3, 4, 5, 6, 7};
+const char *TIME_ZONE = "<-03>3"; // Horário de Brasília (POSIX TZ)
+const char *NTP_SERVER = "pool.ntp.org";
+const uint32_t DAY_MS = 24UL * 60 * 60 * 1000;
 
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RST);
-WebServer server(80);
+Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RST, I2C_FREQUENCY, I2C_FREQUENCY);
+DisplayFlush displayFlush(display, Wire, SCREEN_ADDRESS);
+AsyncWebServer server(80);
+AsyncEventSource events("/events");
 WiFiManager wifiManager;
 
-bool relayStatus[RELAY_COUNT] = {false};
+RelayState relayState;
+RelayHistory relayHistory; // Bitmask das últimas versões, para o delta do /status
+uint16_t bootId = 0;       // Aleatório por boot, entra no ETag do /status
+RelayOutputs relayOutputs(Wire);
+RelayActuator relayActuator; // Só a tarefa do atuador usa
+// Saídas físicas; /status e SSE informam o estado comandado (relayState), que as
+// saídas alcançam após a coalescência e o intervalo mínimo. MQTT e o ack UDP
+// trazem os dois, para o cliente ver quando um comando chegou aos relés.
+std::atomic<uint32_t> relayOutputsMask(0);
+RelayJournal relayJournal(LittleFS, "/relay.jnl", "/relay.tmp");
+RelayScheduler relayScheduler;
+NetworkCache networkCache;
+WiFiClient mqttNetwork;
+MqttLink mqttLink(mqttNetwork);
+char mqttClientId[16];
+AsyncUDP udp;
+UdpControl udpControl;
+OtaStream otaStream;
+OtaResult otaRequestResult = OtaResult::Ok; // Resultado da sessão OTA, devolvido na resposta
+bool otaArgsValid = false;
+AsyncWebServerRequest *otaRequest = NULL; // Envio dono da sessão OTA; outro simultâneo recebe 503
+std::atomic<bool> fsUpdating(false); // Imagem do LittleFS sendo gravada: persistência suspensa
+SemaphoreHandle_t fsMutex = NULL;    // Escritas do journal/agenda x desmontagem do LittleFS
+int openFileResponses = 0;           // Arquivos do LittleFS sendo servidos (só na tarefa do AsyncTCP)
+portMUX_TYPE schedulerMux = portMUX_INITIALIZER_UNLOCKED;
+ScheduleJob pendingClockJobs[SCHEDULER_MAX_JOBS]; // Jobs com horário restaurados antes do NTP
+size_t pendingClockJobCount = 0;
 int currentScreen = 0;
-unsigned long buttonPressStartTime = 0;
-bool isLongPressActive = false;
+RelaySnapshot pushedRelayState = {0, 0};
+SpscRing<ButtonEdge, 16> buttonEdges; // ISR -> tarefa do display
+std::atomic<bool> buttonEdgesOverflow(false); // A ISR achou a fila cheia: bordas perdidas
+ButtonInput buttonInput(DEBOUNCE_DELAY, LONG_PRESS_DURATION, DOUBLE_PRESS_WINDOW);
 portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
-String logBuffer[LOG_MAX_LINES];
-int logIndex = 0;
+portMUX_TYPE relayMux = portMUX_INITIALIZER_UNLOCKED;
+LogRing logRing;
+
+TaskHandle_t displayTaskHandle = NULL;
+std::atomic<uint32_t> displayEventStart(0); // micros() do primeiro evento pendente
+TaskHandle_t statePushTaskHandle = NULL;
+TaskHandle_t journalTaskHandle = NULL;
+TaskHandle_t schedulerTaskHandle = NULL;
+TaskHandle_t mqttTaskHandle = NULL;
+TaskHandle_t actuatorTaskHandle = NULL;
+unsigned long splashEndMs = 0;
+
+// Fases do boot: duração de cada uma e instante de término desde o início da aplicação
+struct BootPhase
+{
+  const char *name;
+  uint32_t durationUs;
+  uint32_t endUs;
+};
+
+BootPhase bootPhases[BOOT_MAX_PHASES];
+int bootPhaseCount = 0;
+portMUX_TYPE bootMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Menor folga de pilha já registrada pela tarefa, em bytes (0 se ela não existe)
+uint32_t taskStackFree(TaskHandle_t task)
+{
+  return task != NULL ? uxTaskGetStackHighWaterMark(task) : 0;
+}
+
+// Métricas exportadas em /metrics e resumidas na tela de informações
+LatencyHistogram frameDrawLatency("heltec_frame_draw_seconds", "Desenho de um quadro no framebuffer");
+LatencyHistogram frameFlushLatency("heltec_frame_flush_seconds", "Envio das diferencas do quadro pelo I2C");
+LatencyHistogram frameEventLatency("heltec_frame_event_latency_seconds", "Evento ate o quadro enviado");
+LatencyHistogram buttonLatency("heltec_button_latency_seconds", "ISR do botao ate a borda processada pela tarefa");
+Counter buttonEdgeOverflows("heltec_button_edge_overflows_total",
+                            "Vezes em que a fila de bordas do botao encheu (estado relido do pino)");
+LatencyHistogram httpIndexLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/\"");
+LatencyHistogram httpStyleLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/style.css\"");
+LatencyHistogram httpScriptLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/script.js\"");
+LatencyHistogram httpRelayLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/relay\"");
+LatencyHistogram httpRelaysLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/relays\"");
+LatencyHistogram httpStatusLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/status\"");
+LatencyHistogram httpLogsLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/logs\"");
+LatencyHistogram httpBootLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/boot\"");
+LatencyHistogram httpMetricsLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/metrics\"");
+LatencyHistogram httpScheduleLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/schedule\"");
+LatencyHistogram httpScheduleAddLatency("heltec_http_handler_seconds", "Tempo do handler HTTP",
+                                        "route=\"/schedule/add\"");
+LatencyHistogram httpScheduleRemoveLatency("heltec_http_handler_seconds", "Tempo do handler HTTP",
+                                           "route=\"/schedule/remove\"");
+LatencyHistogram httpUpdateLatency("heltec_http_handler_seconds", "Tempo do handler HTTP", "route=\"/update\"");
+Counter relayWrites("heltec_relay_writes_total", "Escritas nas saidas dos reles");
+Counter relayWriteFailures("heltec_relay_write_failures_total",
+                           "Escritas nas saidas recusadas (expansor I2C sem ACK), tentadas de novo");
+Counter relaySwitches("heltec_relay_switches_total", "Mudancas de estado de reles individuais");
+Counter relayOutputSwitches("heltec_relay_output_switches_total",
+                            "Comutacoes fisicas dos reles, apos coalescencia e intervalo minimo");
+Counter scheduledActions("heltec_schedule_actions_total", "Acoes executadas pelo agendador");
+Counter mqttCommands("heltec_mqtt_commands_total", "Comandos de reles recebidos por MQTT");
+Counter udpApplied("heltec_udp_commands_total", "Datagramas de controle recebidos por UDP", "result=\"applied\"");
+Counter udpIgnored("heltec_udp_commands_total", "Datagramas de controle recebidos por UDP", "result=\"ignored\"");
+Counter udpRejected("heltec_udp_commands_total", "Datagramas de controle recebidos por UDP", "result=\"rejected\"");
+Gauge heapFree("heltec_heap_free_bytes", "Heap livre", NULL, []() -> uint32_t
+               { return ESP.getFreeHeap(); });
+Gauge heapMinFree("heltec_heap_min_free_bytes", "Menor heap livre desde o boot", NULL, []() -> uint32_t
+                  { return ESP.getMinFreeHeap(); });
+Gauge heapLargestBlock("heltec_heap_largest_free_block_bytes", "Maior bloco alocavel", NULL, []() -> uint32_t
+                       { return ESP.getMaxAllocHeap(); });
+Gauge displayTaskStack("heltec_task_stack_free_bytes", "Menor folga de pilha da tarefa", "task=\"DisplayAndButton\"",
+                       []() -> uint32_t
+                       { return taskStackFree(displayTaskHandle); });
+Gauge serverTaskStack("heltec_task_stack_free_bytes", "Menor folga de pilha da tarefa", "task=\"async_tcp\"",
+                      []() -> uint32_t
+                      { return taskStackFree(xTaskGetHandle("async_tcp")); });
+Gauge statePushTaskStack("heltec_task_stack_free_bytes", "Menor folga de pilha da tarefa", "task=\"StatePush\"",
+                         []() -> uint32_t
+                         { return taskStackFree(statePushTaskHandle); });
+Gauge journalTaskStack("heltec_task_stack_free_bytes", "Menor folga de pilha da tarefa", "task=\"Journal\"",
+                       []() -> uint32_t
+                       { return taskStackFree(journalTaskHandle); });
+Gauge schedulerTaskStack("heltec_task_stack_free_bytes", "Menor folga de pilha da tarefa", "task=\"Scheduler\"",
+                         []() -> uint32_t
+                         { return taskStackFree(schedulerTaskHandle); });
+Gauge actuatorTaskStack("heltec_task_stack_free_bytes", "Menor folga de pilha da tarefa", "task=\"Actuator\"",
+                        []() -> uint32_t
+                        { return taskStackFree(actuatorTaskHandle); });
+Gauge mqttTaskStack("heltec_task_stack_free_bytes", "Menor folga de pilha da tarefa", "task=\"Mqtt\"",
+                    []() -> uint32_t
+                    { return taskStackFree(mqttTaskHandle); });
+Gauge relayOutputsGauge("heltec_relay_outputs_mask", "Saidas fisicas dos reles (bitmask)", NULL, []() -> uint32_t
+                        { return relayOutputsMask.load(); });
+Gauge uptime("heltec_uptime_seconds", "Tempo desde o boot", NULL, []() -> uint32_t
+             { return millis() / 1000; });
+
+LatencyHistogram *const httpRouteLatencies[] = {
+    &httpIndexLatency, &httpStyleLatency, &httpScriptLatency, &httpRelayLatency, &httpRelaysLatency,
+    &httpStatusLatency, &httpLogsLatency, &httpBootLatency, &httpMetricsLatency, &httpScheduleLatency,
+    &httpScheduleAddLatency, &httpScheduleRemoveLatency, &httpUpdateLatency};
+
+void markDisplayEvent()
+{
+  uint32_t expected = 0;
+  displayEventStart.compare_exchange_strong(expected, micros() | 1);
+}
+
+void notifyDisplay(uint32_t events)
+{
+  if (displayTaskHandle == NULL)
+    return;
+
+  markDisplayEvent();
+  xTaskNotify(displayTaskHandle, events, eSetBits);
+}
+
+// Avisa os consumidores (atuador, display e canal de eventos) que os relés mudaram
+void notifyRelayChange()
+{
+  if (actuatorTaskHandle != NULL)
+    xTaskNotifyGive(actuatorTaskHandle);
+
+  notifyDisplay(DISPLAY_EVENT_RELAY);
+
+  if (statePushTaskHandle != NULL)
+    xTaskNotifyGive(statePushTaskHandle);
+
+  if (journalTaskHandle != NULL)
+    xTaskNotifyGive(journalTaskHandle);
+
+  if (mqttTaskHandle != NULL)
+    xTaskNotifyGive(mqttTaskHandle);
+}
+
+void IRAM_ATTR notifyDisplayFromISR(uint32_t events)
+{
+  if (displayTaskHandle == NULL)
+    return;
+
+  BaseType_t higherPriorityTaskWoken = pdFALSE;
+  markDisplayEvent();
+  xTaskNotifyFromISR(displayTaskHandle, events, eSetBits, &higherPriorityTaskWoken);
+  portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
+
+void addLog(LogLevel level, const char *format, va_list args)
+{
+  const LogEntry &entry = logRing.append(level, millis(), format, args);
+  Serial.println(entry.text);
+  notifyDisplay(DISPLAY_EVENT_LOG);
+}
 
-void addLog(const String &message)
+void logMessage(LogLevel level, const char *format, ...)
 {
-  logBuffer[logIndex] = message;
-  logIndex = (logIndex + 1) % LOG_MAX_LINES;
+  va_list args;
+  va_start(args, format);
+  addLog(level, format, args);
+  va_end(args);
 }
 
-void logMessage(const String &message)
+void recordBootPhase(const char *name, uint32_t startUs)
 {
-  Serial.println(message);
-  addLog(message);
+  uint32_t now = micros();
+
+  portENTER_CRITICAL(&bootMux);
+  if (bootPhaseCount < BOOT_MAX_PHASES)
+    bootPhases[bootPhaseCount++] = {name, now - startUs, now};
+  portEXIT_CRITICAL(&bootMux);
+
+  logMessage(LogLevel::Debug, "Boot %s: %lu us", name, (unsigned long)(now - startUs));
 }
 
 void resetWiFiConfig()
 {
-  logMessage("Configurações Wi-Fi resetadas!");
+  logMessage(LogLevel::Warn, "Configurações Wi-Fi resetadas!");
   wifiManager.resetSettings();
   ESP.restart();
 }
 
+// Escreve nas saídas; só a tarefa do atuador chama. GPIOs usam seção crítica
+// para o read-modify-write do registrador não ser interrompido. Retorna false
+// se alguma saída ficou sem escrever (relayOutputs.applied() diz o que entrou).
+bool writeRelayOutputs(uint32_t mask)
+{
+  bool written;
+  if (RelayOutputs::BLOCKING)
+  {
+    written = relayOutputs.write(mask);
+  }
+  else
+  {
+    portENTER_CRITICAL(&relayMux);
+    written = relayOutputs.write(mask);
+    portEXIT_CRITICAL(&relayMux);
+  }
+  relayWrites.inc();
+  if (!written)
+    relayWriteFailures.inc();
+  return written;
+}
+
+// Comanda o estado "target" aos relés selecionados em "touch" e retorna o estado
+// resultante. Não espera a comutação: a tarefa do atuador leva as saídas até ele.
+RelaySnapshot applyRelayMask(uint32_t target, uint32_t touch)
+{
+  RelaySnapshot before = relayState.snapshot();
+  RelaySnapshot after = relayState.apply(target, touch & ALL_RELAYS_MASK);
+  if (after.version == before.version)
+    return after;
+
+  relayHistory.record(after);
+  relaySwitches.inc(__builtin_popcount(before.mask ^ after.mask));
+  notifyRelayChange();
+  return after;
+}
+
 void batchRelayToggle()
 {
   bool toggleState = true;
-  int activeRelays = 0;
+  int activeRelays = __builtin_popcount(relayState.snapshot().mask);
 
-  for (int i = 0; i < RELAY_COUNT; i++)
-    if (relayStatus[i])
-      activeRelays++;
+  toggleState = activeRelays < RELAY_COUNT / 2;
 
-  toggleState = activeRelays < 3;
+  applyRelayMask(toggleState ? ALL_RELAYS_MASK : 0, ALL_RELAYS_MASK);
 
-  for (int i = 0; i < RELAY_COUNT; i++)
+  logMessage(LogLevel::Info, "Relays toggled to: %d", toggleState);
+}
+
+// Relógio já acertado pelo NTP (o ESP32 começa em 1970)
+bool clockSynced()
+{
+  return time(NULL) > 1700000000;
+}
+
+// Milissegundos até a próxima ocorrência do horário local "minute" (minutos do dia)
+uint32_t msUntilClockMinute(int minute)
+{
+  time_t now = time(NULL);
+  struct tm local;
+  localtime_r(&now, &local);
+
+  int32_t seconds = (minute * 60) - (local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec);
+  if (seconds <= 0)
+    seconds += 24 * 3600;
+  return (uint32_t)seconds * 1000;
+}
+
+// Job novo ou reagendado pode vencer antes do prazo em que a tarefa do
+// agendador está dormindo: ela acorda e recalcula
+void notifyScheduler()
+{
+  if (schedulerTaskHandle != NULL)
+    xTaskNotifyGive(schedulerTaskHandle);
+}
+
+int addScheduleJob(const ScheduleJob &job)
+{
+  portENTER_CRITICAL(&schedulerMux);
+  int id = relayScheduler.add(job, millis());
+  portEXIT_CRITICAL(&schedulerMux);
+
+  if (id >= 0)
+    notifyScheduler();
+  return id;
+}
+
+// Arma os jobs com horário restaurados no boot assim que o relógio é acertado
+void armPendingClockJobs()
+{
+  static uint32_t delays[SCHEDULER_MAX_JOBS]; // localtime fora da seção crítica; só a tarefa do agendador
+  for (size_t i = 0; i < pendingClockJobCount; i++)
+    delays[i] = msUntilClockMinute(pendingClockJobs[i].clockMinute);
+
+  int failed = 0;
+  portENTER_CRITICAL(&schedulerMux);
+  for (size_t i = 0; i < pendingClockJobCount; i++)
+  {
+    pendingClockJobs[i].delayMs = delays[i];
+    if (relayScheduler.add(pendingClockJobs[i], millis()) < 0)
+      failed++;
+  }
+  pendingClockJobCount = 0;
+  portEXIT_CRITICAL(&schedulerMux);
+
+  if (failed > 0)
+    logMessage(LogLevel::Error, "Falha ao restaurar %d jobs agendados", failed);
+}
+
+// Persiste os jobs recorrentes; os de execução única são relativos ao boot atual
+bool saveSchedule()
+{
+  // Fora das pilhas de 4 KB das tarefas; protegido pela fsMutex
+  static ScheduleJob jobs[SCHEDULER_MAX_JOBS];
+  size_t count = 0;
+
+  xSemaphoreTake(fsMutex, portMAX_DELAY);
+  portENTER_CRITICAL(&schedulerMux);
+  for (int id = 0; id < RelayScheduler::CAPACITY; id++)
+  {
+    uint32_t remaining;
+    if (relayScheduler.get(id, jobs[count], remaining, millis()) && jobs[count].periodMs != 0)
+      count++;
+  }
+
+  // Jobs com horário ainda aguardando o NTP também continuam salvos
+  for (size_t i = 0; i < pendingClockJobCount && count < SCHEDULER_MAX_JOBS; i++)
+    jobs[count++] = pendingClockJobs[i];
+  portEXIT_CRITICAL(&schedulerMux);
+
+  bool saved = !fsUpdating && saveScheduleJobs(LittleFS, "/schedule.bin", "/schedule.tmp", jobs, count);
+  xSemaphoreGive(fsMutex);
+  return saved;
+}
+
+void applyScheduledAction(const ScheduledAction &action)
+{
+  switch (action.action)
   {
-    relayStatus[i] = toggleState;
-    digitalWrite(relayPins[i], relayStatus[i]);
+  case RelayAction::On:
+    applyRelayMask(action.relays, action.relays);
+    break;
+  case RelayAction::Off:
+    applyRelayMask(0, action.relays);
+    break;
+  default:
+    applyRelayMask(~relayState.snapshot().mask, action.relays);
+    break;
   }
 
-  logMessage("Relays toggled to: " + String(toggleState));
+  scheduledActions.inc();
+  logMessage(LogLevel::Info, "Schedule %d: 0x%lx %s", action.id, (unsigned long)action.relays,
+             action.action == RelayAction::On ? "on" : action.action == RelayAction::Off ? "off" : "toggle");
+}
+
+// O período de 24 h conta em millis(), que deriva do relógio (cristal, ajustes
+// do NTP, horário de verão): cada execução de um job com horário diário
+// recalcula a próxima pelo relógio
+void retimeClockJob(const ScheduledAction &action)
+{
+  uint32_t delay = msUntilClockMinute(action.clockMinute);
+  if (delay < DAY_MS / 2)
+    delay += DAY_MS; // Executou pouco antes do horário: a próxima é amanhã
+
+  ScheduleJob job;
+  uint32_t remaining;
+  bool retimed = false;
+  portENTER_CRITICAL(&schedulerMux);
+  if (relayScheduler.get(action.id, job, remaining, millis()) && job.clockMinute == action.clockMinute &&
+      job.periodMs == DAY_MS)
+    retimed = relayScheduler.retime(action.id, delay, millis());
+  portEXIT_CRITICAL(&schedulerMux);
+
+  if (retimed)
+    notifyScheduler();
 }
 
 void handleShortPress()
@@ -86,6 +486,13 @@ void handleShortPress()
   portEXIT_CRITICAL(&mux);
 }
 
+void handleDoublePress()
+{
+  portENTER_CRITICAL(&mux);
+  currentScreen = 0;
+  portEXIT_CRITICAL(&mux);
+}
+
 void handleLongPressAction()
 {
   switch (currentScreen)
@@ -97,296 +504,1645 @@ void handleLongPressAction()
     resetWiFiConfig();
     break;
   }
-
-  isLongPressActive = true;
 }
 
 void IRAM_ATTR handleButtonPress()
 {
-  unsigned long currentMillis = millis();
+  ButtonEdge edge = {(uint32_t)millis(), digitalRead(BUTTON_PIN) == LOW, (uint32_t)micros()};
+  if (!buttonEdges.push(edge))
+    buttonEdgesOverflow = true;
+  notifyDisplayFromISR(DISPLAY_EVENT_BUTTON);
+}
 
-  if (digitalRead(BUTTON_PIN) == LOW)
+uint32_t handleButtonEvent(ButtonEvent event)
+{
+  switch (event)
   {
-    buttonPressStartTime = currentMillis;
-    isLongPressActive = false;
+  case ButtonEvent::ShortPress:
+    handleShortPress();
+    return DISPLAY_EVENT_SCREEN;
+  case ButtonEvent::DoublePress:
+    handleDoublePress();
+    return DISPLAY_EVENT_SCREEN;
+  case ButtonEvent::LongPress:
+    handleLongPressAction();
+    return 0;
+  default:
+    return 0;
   }
-  else
+}
+
+// Consome as bordas da ISR e retorna os eventos de display resultantes. Com
+// bordas perdidas, o estado é relido do pino e o longo pendente, cancelado.
+uint32_t processButtonInput()
+{
+  uint32_t events = 0;
+  ButtonEdge edge;
+
+  while (buttonEdges.pop(edge))
   {
-    unsigned long pressDuration = currentMillis - buttonPressStartTime;
+    events |= handleButtonEvent(buttonInput.feed(edge));
+    buttonLatency.record(micros() - edge.isrUs);
+  }
 
-    if (pressDuration >= LONG_PRESS_DURATION)
-      isLongPressActive = true;
-    else if (pressDuration >= DEBOUNCE_DELAY && !isLongPressActive)
-      handleShortPress();
+  if (buttonEdgesOverflow.exchange(false))
+  {
+    buttonInput.resync(digitalRead(BUTTON_PIN) == LOW, millis());
+    buttonEdgeOverflows.inc();
   }
+
+  ButtonEvent event;
+  while ((event = buttonInput.poll(millis())) != ButtonEvent::None)
+    events |= handleButtonEvent(event);
+
+  return events;
 }
 
-void checkLongPressAction()
+// Latência compacta para a tela: "850us", "12ms", ">1s"
+void formatLatency(char *buffer, size_t size, uint32_t us)
 {
-  if (!isLongPressActive && digitalRead(BUTTON_PIN) == LOW)
-  {
-    unsigned long pressDuration = millis() - buttonPressStartTime;
-    if (pressDuration >= 2000)
-      handleLongPressAction();
-  }
+  if (us == UINT32_MAX)
+    snprintf(buffer, size, ">1s");
+  else if (us < 1000)
+    snprintf(buffer, size, "%luus", (unsigned long)us);
+  else
+    snprintf(buffer, size, "%lums", (unsigned long)(us / 1000));
 }
 
-void drawRelayStatusScreen()
+// --- Telas em modo retido: cada widget só é redesenhado quando seu valor muda ---
+
+uint32_t relayMaskValue()
+{
+  return relayState.snapshot().mask;
+}
+
+uint32_t networkVersion()
+{
+  return networkCache.version();
+}
+
+uint32_t logVersion()
+{
+  return logRing.nextSeq();
+}
+
+uint32_t staticVersion()
+{
+  return 0;
+}
+
+// Tabela dos relés com os bitmaps já no formato de páginas; o tipo de "gfx"
+// escolhe a sobrecarga de blitPaged (framebuffer ou pixel a pixel)
+template <typename Gfx>
+static void blitRelayTable(Gfx &gfx, uint32_t mask)
 {
-  display.clearDisplay();
-  display.setCursor(26, 3);
-  display.print("Relay Status:");
-  display.drawLine(2, 13, 125, 13, 1);
-  display.drawBitmap(1, 27, Table, 127, 36, 1);
-  display.drawBitmap(4, 33, OffArrayLabel, 120, 5, 1);
+  blitPaged(gfx, TablePaged, 1, 27, BlitMode::Set);
+  blitPaged(gfx, OffArrayLabelPaged, 4, 33, BlitMode::Set);
 
   for (int i = 0; i < RELAY_COUNT; i++)
   {
-    if (relayStatus[i])
+    if (mask & (1u << i))
     {
-      display.drawBitmap(i * 18 + 3, 29, TableCell, 15, 14, 1);
-      display.drawBitmap(i * 18 + 6, 34, OnLabel, 9, 4, 0);
+      blitPaged(gfx, TableCellPaged, i * 18 + 3, 29, BlitMode::Set);
+      blitPaged(gfx, OnLabelPaged, i * 18 + 6, 34, BlitMode::Clear);
     }
   }
-  display.display();
 }
 
-void drawWiFiStatusScreen()
+void drawRelayTable(Adafruit_GFX &gfx, uint32_t mask)
 {
-  display.clearDisplay();
-  display.setCursor(26, 3);
-  display.print("WiFi Status:");
-  display.drawLine(2, 13, 125, 13, 1);
-
-  if (WiFi.status() == WL_CONNECTED)
+  if (RELAY_COUNT > 7)
   {
-    display.setCursor(0, 25);
-    display.print("SSID: ");
-    display.print(WiFi.SSID());
-    display.setCursor(0, 35);
-    display.print("IP: ");
-    display.print(WiFi.localIP());
-    display.setCursor(0, 45);
-    display.print("Gateway: ");
-    display.print(WiFi.gatewayIP());
-    display.setCursor(0, 55);
-    display.print("MAC:");
-    display.print(WiFi.macAddress());
+    // Mais relés do que a tabela desenhada comporta: grade de 8 colunas
+    const int rows = (RELAY_COUNT + 7) / 8;
+    const int rowHeight = 48 / rows;
+    for (int i = 0; i < RELAY_COUNT; i++)
+    {
+      int x = (i % 8) * 16 + 1;
+      int y = 16 + (i / 8) * rowHeight;
+      if (mask & (1u << i))
+        gfx.fillRect(x, y, 14, rowHeight - 2, 1);
+      else
+        gfx.drawRect(x, y, 14, rowHeight - 2, 1);
+    }
+    return;
   }
+
+  // Desenhando no display: bitmaps combinados direto no framebuffer
+  if (&gfx == &display)
+    blitRelayTable(display, mask);
   else
+    blitRelayTable(gfx, mask);
+}
+
+// Linhas da tela de rede, lidas do cache: 0 SSID, 1 IP, 2 gateway, 3 MAC
+void networkLine(char *buffer, size_t size, int line)
+{
+  NetworkSnapshot network;
+  networkCache.read(network);
+
+  if (!network.connected)
+  {
+    if (line == 0)
+      snprintf(buffer, size, "Nao conectado");
+    return;
+  }
+
+  switch (line)
+  {
+  case 0:
+    snprintf(buffer, size, "SSID: %s", network.ssid);
+    break;
+  case 1:
+    snprintf(buffer, size, "IP: %s", network.ip);
+    break;
+  case 2:
+    snprintf(buffer, size, "Gateway: %s", network.gateway);
+    break;
+  case 3:
+    snprintf(buffer, size, "MAC:%s", network.mac);
+    break;
+  }
+}
+
+// Linhas da tela de informações; a 0 é fixa, as demais são lidas a cada tick
+void espInfoLine(char *buffer, size_t size, int line)
+{
+  char draw[8], flush[8];
+
+  switch (line)
+  {
+  case 0:
+    snprintf(buffer, size, "Chip %lX %luMHz", (unsigned long)(uint32_t)ESP.getEfuseMac(),
+             (unsigned long)ESP.getCpuFreqMHz());
+    break;
+  case 1:
+    snprintf(buffer, size, "Heap %luK max %luK", (unsigned long)(ESP.getFreeHeap() / 1024),
+             (unsigned long)(ESP.getMaxAllocHeap() / 1024));
+    break;
+  case 2:
+    snprintf(buffer, size, "Stack D:%lu S:%lu", (unsigned long)taskStackFree(displayTaskHandle),
+             (unsigned long)taskStackFree(xTaskGetHandle("async_tcp")));
+    break;
+  case 3:
+    formatLatency(draw, sizeof(draw), frameDrawLatency.percentileUs(99));
+    formatLatency(flush, sizeof(flush), frameFlushLatency.percentileUs(99));
+    snprintf(buffer, size, "Frame p99 %s+%s", draw, flush);
+    break;
+  case 4:
   {
-    display.setCursor(10, 30);
-    display.print("Nao conectado");
+    // Percentil 99 da pior rota HTTP
+    uint32_t httpP99 = 0;
+    for (LatencyHistogram *histogram : httpRouteLatencies)
+    {
+      uint32_t p99 = histogram->percentileUs(99);
+      if (p99 > httpP99)
+        httpP99 = p99;
+    }
+    formatLatency(draw, sizeof(draw), httpP99);
+    snprintf(buffer, size, "HTTP p99 %s", draw);
+    break;
+  }
+  case 5:
+    formatLatency(draw, sizeof(draw), buttonLatency.percentileUs(99));
+    snprintf(buffer, size, "Btn %s Relay %lu", draw, (unsigned long)relaySwitches.get());
+    break;
   }
-  display.display();
 }
 
-void drawESPInfoScreen()
+// Últimas linhas do log, que cabem na tela
+void logLine(char *buffer, size_t size, int line)
 {
-  display.clearDisplay();
-  display.setCursor(26, 3);
-  display.print("ESP32 Info:");
-  display.drawLine(2, 13, 125, 13, 1);
+  uint32_t next = logRing.nextSeq();
+  uint32_t first = next > LOG_SCREEN_LINES ? next - LOG_SCREEN_LINES : 0;
+  LogEntry entry;
+
+  if (first + line < next && logRing.read(first + line, entry))
+    snprintf(buffer, size, "%s", entry.text);
+}
+
+Rule headerRule(2, 13, 124);
+
+Label relayTitle(26, 3, "Relay Status:");
+ValueWidget relayTable(1, 16, 127, 48, relayMaskValue, drawRelayTable);
+Widget *const relayWidgets[] = {&relayTitle, &headerRule, &relayTable};
+
+Label wifiTitle(26, 3, "WiFi Status:");
+TextField wifiLines[] = {
+    TextField(0, 25, 128, networkLine, 0, networkVersion),
+    TextField(0, 35, 128, networkLine, 1, networkVersion),
+    TextField(0, 45, 128, networkLine, 2, networkVersion),
+    TextField(0, 55, 128, networkLine, 3, networkVersion)};
+Widget *const wifiWidgets[] = {&wifiTitle, &headerRule, &wifiLines[0], &wifiLines[1], &wifiLines[2], &wifiLines[3]};
 
-  display.setCursor(0, 25);
-  display.print("Chip ID: ");
-  display.print((uint32_t)ESP.getEfuseMac(), HEX);
+Label espInfoTitle(26, 3, "ESP32 Info:");
+TextField espInfoLines[] = {
+    TextField(0, 15, 128, espInfoLine, 0, staticVersion),
+    TextField(0, 23, 128, espInfoLine, 1),
+    TextField(0, 31, 128, espInfoLine, 2),
+    TextField(0, 39, 128, espInfoLine, 3),
+    TextField(0, 47, 128, espInfoLine, 4),
+    TextField(0, 55, 128, espInfoLine, 5)};
+Widget *const espInfoWidgets[] = {&espInfoTitle, &headerRule, &espInfoLines[0], &espInfoLines[1],
+                                  &espInfoLines[2], &espInfoLines[3], &espInfoLines[4], &espInfoLines[5]};
 
-  display.setCursor(0, 35);
-  display.print("Cores: ");
-  display.print(ESP.getChipCores());
+Label logTitle(50, 3, "Logs:");
+TextField logLines[LOG_SCREEN_LINES] = {
+    TextField(0, 15, 128, logLine, 0, logVersion),
+    TextField(0, 23, 128, logLine, 1, logVersion),
+    TextField(0, 31, 128, logLine, 2, logVersion),
+    TextField(0, 39, 128, logLine, 3, logVersion),
+    TextField(0, 47, 128, logLine, 4, logVersion),
+    TextField(0, 55, 128, logLine, 5, logVersion)};
+Widget *const logWidgets[] = {&logTitle, &headerRule, &logLines[0], &logLines[1],
+                              &logLines[2], &logLines[3], &logLines[4], &logLines[5]};
 
-  display.setCursor(0, 45);
-  display.print("CPU Freq: ");
-  display.print(ESP.getCpuFreqMHz());
-  display.print(" MHz");
+Screen relayScreen(relayWidgets);
+Screen wifiScreen(wifiWidgets);
+Screen espInfoScreen(espInfoWidgets);
+Screen logScreen(logWidgets);
+Screen *const screens[] = {&relayScreen, &wifiScreen, &espInfoScreen, &logScreen};
+int renderedScreen = -1; // Tela cujo desenho está retido no framebuffer
 
-  display.setCursor(0, 55);
-  display.print("Flash: ");
-  display.print(ESP.getFlashChipSize() / (1024 * 1024));
-  display.print(" MB");
+// Evento SSE compacto: "c" = relés alterados, "s" = estado atual (bitmasks), "v" = versão
+int formatRelayEvent(char *buffer, size_t size, uint32_t changed, const RelaySnapshot &snap)
+{
+  return snprintf(buffer, size, "{\"c\":%lu,\"s\":%lu,\"v\":%lu}",
+                  (unsigned long)changed, (unsigned long)snap.mask, (unsigned long)snap.version);
+}
+
+void handleEventsConnect(AsyncEventSourceClient *client)
+{
+  char event[64];
+  formatRelayEvent(event, sizeof(event), ALL_RELAYS_MASK, relayState.snapshot());
+  client->send(event, "state", 0, 2000);
+}
+
+// Envia o delta dos relés aos clientes SSE quando o estado muda
+void pushRelayState()
+{
+  RelaySnapshot snap = relayState.snapshot();
+  if (snap.version == pushedRelayState.version)
+    return;
 
-  display.display();
+  char event[64];
+  formatRelayEvent(event, sizeof(event), snap.mask ^ pushedRelayState.mask, snap);
+  events.send(event, "state", snap.version);
+  pushedRelayState = snap;
 }
 
-void drawLogScreen()
+// Formatos do /status: "relayN"/"version" (padrão), lista compacta ou bitmask
+enum class StatusFormat : uint8_t
 {
-  display.clearDisplay();
-  display.setCursor(50, 3);
-  display.print("Logs:");
-  display.drawLine(2, 13, 125, 13, 1);
+  Named,
+  Array,
+  Mask
+};
 
-  int y = 15;
-  int startIndex = (logIndex + LOG_MAX_LINES - 6) % LOG_MAX_LINES; // Começar pelos últimos 7 logs
+// Resposta do /status. Delta: só os relés em "changed" (Named) ou o evento
+// compacto {"c","s","v"} (Array/Mask).
+struct StatusReply
+{
+  RelaySnapshot snap;
+  uint32_t changed;
+  StatusFormat format;
+  bool delta;
+};
+
+const size_t STATUS_JSON_SIZE = 24 + RELAY_COUNT * 16;
+
+size_t formatRelayStatus(char *buffer, size_t size, const StatusReply &reply)
+{
+  const RelaySnapshot &snap = reply.snap;
+  int len;
 
-  for (int i = 0; i < 6; i++) // Mostrar 7 linhas, que cabem na tela sem sobreposição
+  if (reply.delta && reply.format != StatusFormat::Named)
+    return formatRelayEvent(buffer, size, reply.changed, snap);
+
+  switch (reply.format)
   {
-    int index = (startIndex + i) % LOG_MAX_LINES;
-    display.setCursor(0, y);
-    display.print(logBuffer[index]);
-    y += 8;
+  case StatusFormat::Mask:
+    len = snprintf(buffer, size, "{\"s\":%lu,\"v\":%lu,\"n\":%d}", (unsigned long)snap.mask,
+                   (unsigned long)snap.version, RELAY_COUNT);
+    break;
+  case StatusFormat::Array:
+    len = snprintf(buffer, size, "{\"r\":[");
+    for (int i = 0; i < RELAY_COUNT; i++)
+      len += snprintf(buffer + len, size - len, "%s%d", i > 0 ? "," : "", (snap.mask >> i) & 1);
+    len += snprintf(buffer + len, size - len, "],\"v\":%lu}", (unsigned long)snap.version);
+    break;
+  default:
+    len = snprintf(buffer, size, "{");
+    for (int i = 0; i < RELAY_COUNT; i++)
+    {
+      if (reply.delta && !(reply.changed & (1u << i)))
+        continue;
+      len += snprintf(buffer + len, size - len, "\"relay%d\":%s,", i, snap.mask & (1u << i) ? "true" : "false");
+    }
+    len += snprintf(buffer + len, size - len, "\"version\":%lu}", (unsigned long)snap.version);
+    break;
   }
 
-  display.display();
+  return len;
 }
 
-void handleGetRelayStatus()
+// ETag do estado: id do boot + versão, para não casar com versões de outro boot.
+// Curto para o header não precisar de alocação própria na String.
+int formatStatusETag(char *buffer, size_t size, uint32_t version)
 {
-  JsonDocument jsonDoc;
-  for (int i = 0; i < RELAY_COUNT; i++)
-  {
-    jsonDoc["relay" + String(i)] = relayStatus[i];
-  }
-  String json;
-  serializeJson(jsonDoc, json);
-  server.send(200, "application/json", json);
+  return snprintf(buffer, size, "\"%04x-%lu\"", bootId, (unsigned long)version);
 }
 
-void serveFile(const char *path, const char *contentType)
+// O std::function do filler guarda inline só dois ponteiros (8 bytes no
+// Xtensa); uma captura maior é alocada no heap a cada resposta
+template <typename Filler>
+AwsResponseFiller inlineFiller(Filler filler)
 {
-  File file = LittleFS.open(path, "r");
-  if (!file)
-  {
-    server.send(404, "text/plain", "Arquivo não encontrado");
-    return;
-  }
-  server.streamFile(file, contentType);
-  file.close();
+  static_assert(sizeof(Filler) <= 2 * sizeof(void *) && std::is_trivially_copyable<Filler>::value,
+                "captura do filler não cabe no std::function sem alocar");
+  return filler;
 }
 
-void handleRelayControl()
+// Resposta do /status dona do próprio estado: o corpo é formatado direto no
+// buffer de envio do AsyncTCP e continua igual ao Content-Length mesmo com o
+// cliente lento e outras respostas saindo no meio. Ocupa o lugar da
+// AsyncCallbackResponse que o beginResponse alocaria, sem std::function.
+class StatusResponse : public AsyncAbstractResponse
 {
-  if (server.hasArg("relay") && server.hasArg("state"))
+public:
+  StatusResponse() { _contentType = JSON_CONTENT_TYPE; }
+
+  // Estado completo ou delta
+  void setReply(const StatusReply &value)
   {
-    int relayNum = server.arg("relay").toInt();
-    String state = server.arg("state");
+    char json[STATUS_JSON_SIZE];
+    reply = value;
+    _code = 200;
+    _contentLength = formatRelayStatus(json, sizeof(json), reply);
+    addETag(reply.snap.version);
+  }
 
-    if (relayNum >= 0 && relayNum < RELAY_COUNT && (state == "on" || state == "off"))
+  // A partir da versão "since": 304, delta (se a versão ainda está no
+  // histórico) ou o estado completo
+  void setSince(uint32_t since, StatusFormat format, bool delta)
+  {
+    RelaySnapshot snap = relayState.snapshot();
+    if (snap.version == since)
     {
-      relayStatus[relayNum] = (state == "on");
-      digitalWrite(relayPins[relayNum], relayStatus[relayNum]);
-      logMessage("Relay " + String(relayNum + 1) + ": " + state);
-
-      server.send(200, "text/plain", "OK");
+      _code = 304;
+      _contentLength = 0;
+      addETag(since);
+      return;
     }
-    else
+
+    uint32_t sinceMask;
+    StatusReply value = {snap, 0, format, false};
+    if (delta && relayHistory.find(since, sinceMask))
     {
-      server.send(400, "text/plain", "Número de relé inválido ou estado inválido.");
+      value.changed = sinceMask ^ snap.mask;
+      value.delta = true;
     }
+    setReply(value);
   }
-  else
+
+  bool _sourceValid() const override { return true; }
+
+  size_t _fillBuffer(uint8_t *buffer, size_t maxLen) override
   {
-    server.send(400, "text/plain", "Parâmetros 'relay' e 'state' são obrigatórios.");
+    char json[STATUS_JSON_SIZE];
+    size_t length = formatRelayStatus(json, sizeof(json), reply);
+    size_t len = filled < length ? length - filled : 0;
+    if (len > maxLen)
+      len = maxLen;
+    memcpy(buffer, json + filled, len);
+    filled += len;
+    return len;
   }
-}
 
-void setupServer()
+private:
+  void addETag(uint32_t version)
+  {
+    char etag[24];
+    formatStatusETag(etag, sizeof(etag), version);
+    addHeader("ETag", etag);
+  }
+
+  StatusReply reply;
+  size_t filled = 0;
+};
+
+// Envia o estado sem JsonDocument nem String
+void sendRelayStatus(AsyncWebServerRequest *request, const RelaySnapshot &snap, StatusFormat format)
 {
-  server.on("/", []()
-            { serveFile("/index.html", "text/html"); });
-  server.on("/style.css", []()
-            { serveFile("/style.css", "text/css"); });
-  server.on("/script.js", []()
-            { serveFile("/script.js", "application/javascript"); });
-  server.on("/relay", handleRelayControl);
-  server.on("/status", handleGetRelayStatus);
-  server.begin();
+  StatusResponse *response = new StatusResponse();
+  StatusReply reply = {snap, 0, format, false};
+  response->setReply(reply);
+  request->send(response);
 }
 
-void taskDisplayAndButton(void *pvParameters)
+void sendRelayStatusSince(AsyncWebServerRequest *request, uint32_t since, StatusFormat format, bool delta)
 {
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setTextWrap(false);
+  StatusResponse *response = new StatusResponse();
+  response->setSince(since, format, delta);
+  request->send(response);
+}
 
-  for (;;)
+// Esperas do long-poll em andamento (só na tarefa do AsyncTCP)
+int statusPollWaiting = 0;
+
+// Long-poll do /status: a resposta fica estacionada, sem headers, e o servidor
+// a consulta a cada poll da conexão (~500 ms, na tarefa do AsyncTCP). Quando
+// a versão muda ou o prazo vence, vira o 200/304 normal. Nenhuma outra tarefa
+// toca a requisição, e a desconexão apaga a resposta junto com ela.
+class StatusPollResponse : public StatusResponse
+{
+public:
+  StatusPollResponse(uint32_t since, uint32_t deadlineMs, StatusFormat format, bool delta)
+      : since(since), deadlineMs(deadlineMs), format(format), delta(delta)
   {
-    switch (currentScreen)
-    {
-    case 0:
-      drawRelayStatusScreen();
-      break;
-    case 1:
-      drawWiFiStatusScreen();
-      break;
-    case 2:
-      drawESPInfoScreen();
-      break;
-    case 3:
-      drawLogScreen();
-      break;
-    }
-    checkLongPressAction(); // Checa se o pressionamento longo foi atingido
-    vTaskDelay(200 / portTICK_PERIOD_MS);
+    statusPollWaiting++;
   }
-}
 
-void taskServer(void *pvParameters)
-{
-  for (;;)
+  ~StatusPollResponse()
   {
-    server.handleClient();
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+    if (parked)
+      statusPollWaiting--;
   }
-}
 
-void setupDisplay()
-{
-  Wire.begin(OLED_SDA, OLED_SCL);
-  Wire.setClock(I2C_FREQUENCY);
+  void _respond(AsyncWebServerRequest *request) override {}
 
-  if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS))
+  size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time) override
   {
-    logMessage("Falha na inicialização do display SSD1306");
-    ESP.restart();
+    if (!parked)
+      return StatusResponse::_ack(request, len, time);
+    if (relayState.snapshot().version == since && (int32_t)(deadlineMs - millis()) > 0)
+      return 0;
+
+    parked = false;
+    statusPollWaiting--;
+    setSince(since, format, delta);
+    StatusResponse::_respond(request);
+    return 0;
   }
 
-  display.display();
-  delay(2000);
-}
+private:
+  uint32_t since;
+  uint32_t deadlineMs;
+  StatusFormat format;
+  bool delta;
+  bool parked = true;
+};
 
-void setupIO()
+// /status[?format=named|array|mask][&since=<versão>][&wait=<ms>], ou If-None-Match
+// com o ETag recebido. Sem mudança: 304 na hora ou, com "wait", quando mudar ou
+// o prazo vencer. Com "since", a resposta traz só os relés alterados.
+void handleGetRelayStatus(AsyncWebServerRequest *request)
 {
-  pinMode(BUTTON_PIN, INPUT_PULLUP);
-  attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), handleButtonPress, CHANGE);
+  StatusFormat format = StatusFormat::Named;
 
-  for (int i = 0; i < RELAY_COUNT; i++)
+  if (request->hasArg("format"))
   {
-    pinMode(relayPins[i], OUTPUT);
-    digitalWrite(relayPins[i], LOW);
+    const String &name = request->arg("format");
+    if (name == "array")
+      format = StatusFormat::Array;
+    else if (name == "mask")
+      format = StatusFormat::Mask;
   }
-}
 
-void setupFileSystem()
-{
-  if (!LittleFS.begin())
+  uint32_t since;
+  bool delta = request->hasArg("since");
+  if (delta)
   {
-    logMessage("Falha ao montar o LittleFS");
-    ESP.restart();
+    char *end;
+    since = strtoul(request->arg("since").c_str(), &end, 10);
+    if (*end != '\0')
+    {
+      request->send(400, "text/plain", "Parâmetro 'since' inválido.");
+      return;
+    }
+  }
+  else
+  {
+    // ETag de outro boot ou malformado: resposta completa
+    unsigned long etagBoot, etagVersion;
+    int consumed = 0;
+    if (!request->hasHeader("If-None-Match") ||
+        sscanf(request->header("If-None-Match").c_str(), "\"%4lx-%lu\"%n", &etagBoot, &etagVersion, &consumed) != 2 ||
+        consumed == 0 || etagBoot != bootId)
+    {
+      sendRelayStatus(request, relayState.snapshot(), format);
+      return;
+    }
+    since = etagVersion;
   }
-}
 
-void setupWifi()
-{
-  wifiManager.autoConnect("ESP32-Setup");
+  uint32_t wait = 0;
+  if (request->hasArg("wait"))
+  {
+    wait = request->arg("wait").toInt();
+    if (wait > STATUS_POLL_MAX_MS)
+      wait = STATUS_POLL_MAX_MS;
+  }
 
-  if (WiFi.status() == WL_CONNECTED)
+  // Sem mudança e com vaga: estaciona até mudar ou o prazo vencer
+  if (wait == 0 || relayState.snapshot().version != since || statusPollWaiting >= STATUS_POLL_MAX_WAITERS)
   {
-    logMessage("Conectado!");
+    sendRelayStatusSince(request, since, format, delta);
+    return;
   }
+  request->send(new StatusPollResponse(since, millis() + wait, format, delta));
+}
+
+// Arquivo estático servido a partir da versão pré-comprimida (<path>.gz) gerada por compress_assets.py
+struct StaticAsset
+{
+  const char *path;
+  const char *gzipPath;
+  const char *contentType;
+  const char *cacheControl;
+  char etag[11]; // "xxxxxxxx", calculado no primeiro acesso
+};
+
+StaticAsset staticAssets[] = {
+    {"/index.html", "/index.html.gz", "text/html", "no-cache", ""},
+    {"/style.css", "/style.css.gz", "text/css", "public, max-age=31536000, immutable", ""},
+    {"/script.js", "/script.js.gz", "application/javascript", "public, max-age=31536000, immutable", ""},
+};
+
+// ETag forte: FNV-1a do conteúdo comprimido
+bool computeAssetETag(StaticAsset &asset)
+{
+  File file = LittleFS.open(asset.gzipPath, "r");
+  if (!file)
+    return false;
+
+  uint32_t hash = 2166136261u;
+  uint8_t buffer[256];
+  size_t len;
+  while ((len = file.read(buffer, sizeof(buffer))) > 0)
+  {
+    for (size_t i = 0; i < len; i++)
+      hash = (hash ^ buffer[i]) * 16777619u;
+  }
+  file.close();
+
+  snprintf(asset.etag, sizeof(asset.etag), "\"%08lx\"", (unsigned long)hash);
+  return true;
+}
+
+// A resposta lê o arquivo aos poucos até a conexão fechar: o LittleFS não
+// pode ser desmontado antes disso
+void trackFileResponse(AsyncWebServerRequest *request)
+{
+  openFileResponses++;
+  request->onDisconnect([]()
+                        { openFileResponses--; });
+}
+
+void serveFile(AsyncWebServerRequest *request, StaticAsset &asset)
+{
+  if (fsUpdating)
+  {
+    request->send(503, "text/plain", "Sistema de arquivos em atualização");
+    return;
+  }
+
+  if (asset.etag[0] == '\0' && !computeAssetETag(asset))
+  {
+    // Sem .gz (data/ enviado sem o script de build): serve o original
+    if (!LittleFS.exists(asset.path))
+    {
+      request->send(404, "text/plain", "Arquivo não encontrado");
+      return;
+    }
+    trackFileResponse(request);
+    request->send(LittleFS, asset.path, asset.contentType);
+    return;
+  }
+
+  AsyncWebServerResponse *response;
+  if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == asset.etag)
+  {
+    response = request->beginResponse(304);
+  }
+  else
+  {
+    trackFileResponse(request);
+    response = request->beginResponse(LittleFS, asset.gzipPath, asset.contentType);
+    response->addHeader("Content-Encoding", "gzip");
+  }
+  response->addHeader("ETag", asset.etag);
+  response->addHeader("Cache-Control", asset.cacheControl);
+  request->send(response);
+}
+
+void handleRelayControl(AsyncWebServerRequest *request)
+{
+  if (request->hasArg("relay") && request->hasArg("state"))
+  {
+    int relayNum = request->arg("relay").toInt();
+    const String &state = request->arg("state");
+
+    if (relayNum >= 0 && relayNum < RELAY_COUNT && (state == "on" || state == "off"))
+    {
+      applyRelayMask(state == "on" ? 1u << relayNum : 0, 1u << relayNum);
+      logMessage(LogLevel::Info, "Relay %d: %s", relayNum + 1, state.c_str());
+
+      request->send(200, "text/plain", "OK");
+    }
+    else
+    {
+      request->send(400, "text/plain", "Número de relé inválido ou estado inválido.");
+    }
+  }
+  else
+  {
+    request->send(400, "text/plain", "Parâmetros 'relay' e 'state' são obrigatórios.");
+  }
+}
+
+// Aplica vários relés de uma vez: mask = estado desejado, touch = relés afetados (opcional)
+// Lê um argumento numérico opcional; falso se presente e inválido
+bool parseNumberArg(AsyncWebServerRequest *request, const char *name, uint32_t &value)
+{
+  if (!request->hasArg(name))
+    return true;
+
+  char *end;
+  const String &text = request->arg(name);
+  value = strtoul(text.c_str(), &end, 0);
+  return !text.isEmpty() && *end == '\0';
+}
+
+void handleRelayBatch(AsyncWebServerRequest *request)
+{
+  if (!request->hasArg("mask"))
+  {
+    request->send(400, "text/plain", "Parâmetro 'mask' é obrigatório.");
+    return;
+  }
+
+  // Vazio ou não numérico é recusado (strtoul sozinho leria 0: desligaria tudo)
+  uint32_t target = 0;
+  uint32_t touch = ALL_RELAYS_MASK;
+  bool valid = parseNumberArg(request, "mask", target) && parseNumberArg(request, "touch", touch);
+
+  if (!valid || (target | touch) & ~ALL_RELAYS_MASK)
+  {
+    request->send(400, "text/plain", "Máscara de relés inválida.");
+    return;
+  }
+
+  RelaySnapshot snap = applyRelayMask(target, touch);
+  logMessage(LogLevel::Info, "Relays set: 0x%lx (touch 0x%lx)", (unsigned long)snap.mask, (unsigned long)touch);
+
+  sendRelayStatus(request, snap, StatusFormat::Mask);
+}
+
+// Transmite o buffer de logs (a partir de "since", opcional) sem copiá-lo para uma String
+void handleGetLogs(AsyncWebServerRequest *request)
+{
+  uint32_t end = logRing.nextSeq();
+  uint32_t cursor = logRing.oldestSeq();
+
+  if (request->hasArg("since"))
+  {
+    uint32_t since = strtoul(request->arg("since").c_str(), NULL, 10);
+    if (since > cursor)
+      cursor = since < end ? since : end;
+  }
+
+  AsyncWebServerResponse *response = request->beginChunkedResponse(
+      "text/plain", inlineFiller([cursor, end](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t
+      {
+        size_t written = 0;
+        LogEntry entry;
+
+        for (; cursor < end; cursor++)
+        {
+          if (!logRing.read(cursor, entry))
+            continue; // Sobrescrita enquanto transmitia
+
+          int len = snprintf((char *)buffer + written, maxLen - written, "%lu\t%lu\t%s\t%s\n",
+                             (unsigned long)entry.seq, (unsigned long)entry.timestampMs,
+                             LogRing::levelName(entry.level), entry.text);
+          if (len < 0 || (size_t)len >= maxLen - written)
+            break;
+          written += len;
+        }
+
+        return written;
+      }));
+  response->addHeader("X-Log-Next", String(end));
+  request->send(response);
+}
+
+void handleGetBoot(AsyncWebServerRequest *request)
+{
+  char json[64 + BOOT_MAX_PHASES * 64];
+  int len = snprintf(json, sizeof(json), "{\"phases\":[");
+
+  portENTER_CRITICAL(&bootMux);
+  int count = bootPhaseCount;
+  portEXIT_CRITICAL(&bootMux);
+
+  for (int i = 0; i < count; i++)
+  {
+    len += snprintf(json + len, sizeof(json) - len, "%s{\"name\":\"%s\",\"us\":%lu,\"at\":%lu}",
+                    i > 0 ? "," : "", bootPhases[i].name,
+                    (unsigned long)bootPhases[i].durationUs, (unsigned long)bootPhases[i].endUs);
+  }
+  snprintf(json + len, sizeof(json) - len, "]}");
+
+  request->send(200, "application/json", json);
+}
+
+void handleGetMetrics(AsyncWebServerRequest *request)
+{
+  MetricsExporter exporter;
+  AsyncWebServerResponse *response = request->beginChunkedResponse(
+      "text/plain; version=0.0.4",
+      inlineFiller([exporter](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t
+                   { return exporter.read((char *)buffer, maxLen); }));
+  request->send(response);
+}
+
+// Envolve o handler da rota medindo seu tempo de execução (respostas chunked
+// contam só a montagem; o envio acontece depois, na tarefa do AsyncTCP)
+ArRequestHandlerFunction timedRoute(LatencyHistogram &histogram, ArRequestHandlerFunction handler)
+{
+  return [&histogram, handler](AsyncWebServerRequest *request)
+  {
+    uint32_t start = micros();
+    handler(request);
+    histogram.record(micros() - start);
+  };
+}
+
+const char *relayActionName(RelayAction action)
+{
+  switch (action)
+  {
+  case RelayAction::On:
+    return "on";
+  case RelayAction::Off:
+    return "off";
+  case RelayAction::Toggle:
+    return "toggle";
+  default:
+    return "pulse";
+  }
+}
+
+// Lista os jobs agendados (JSON) sem montar a resposta inteira na memória
+void handleGetSchedule(AsyncWebServerRequest *request)
+{
+  int cursor = -1; // -1: ainda falta abrir a lista
+  bool first = true;
+
+  AsyncWebServerResponse *response = request->beginChunkedResponse(
+      "application/json", inlineFiller([cursor, first](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t
+      {
+        size_t written = 0;
+
+        if (cursor < 0 && maxLen > 0)
+        {
+          buffer[written++] = '[';
+          cursor = 0;
+        }
+
+        for (; cursor >= 0 && cursor < RelayScheduler::CAPACITY; cursor++)
+        {
+          ScheduleJob job;
+          uint32_t remaining;
+
+          portENTER_CRITICAL(&schedulerMux);
+          bool found = relayScheduler.get(cursor, job, remaining, millis());
+          portEXIT_CRITICAL(&schedulerMux);
+          if (!found)
+            continue;
+
+          char at[12] = "null";
+          if (job.clockMinute >= 0)
+            snprintf(at, sizeof(at), "\"%02d:%02d\"", job.clockMinute / 60, job.clockMinute % 60);
+
+          int len = snprintf((char *)buffer + written, maxLen - written,
+                             "%s{\"id\":%d,\"action\":\"%s\",\"relays\":%lu,\"period\":%lu,\"pulse\":%lu,"
+                             "\"at\":%s,\"next\":%lu}",
+                             first ? "" : ",", cursor, relayActionName(job.action), (unsigned long)job.relays,
+                             (unsigned long)job.periodMs, (unsigned long)job.pulseMs, at, (unsigned long)remaining);
+          if (len < 0 || (size_t)len >= maxLen - written)
+            break;
+          written += len;
+          first = false;
+        }
+
+        if (cursor == RelayScheduler::CAPACITY && written < maxLen)
+        {
+          buffer[written++] = ']';
+          cursor++;
+        }
+
+        return written;
+      }));
+  request->send(response);
+}
+
+// Agenda uma ação: action=on|off|toggle|pulse, relays=bitmask (ou relay=N),
+// delay/period/pulse em ms e, opcionalmente, at=HH:MM (diário por padrão)
+void handleScheduleAdd(AsyncWebServerRequest *request)
+{
+  ScheduleJob job = {RelayAction::On, 0, 0, 0, 0, -1};
+  const String &action = request->arg("action");
+
+  if (action == "on")
+    job.action = RelayAction::On;
+  else if (action == "off")
+    job.action = RelayAction::Off;
+  else if (action == "toggle")
+    job.action = RelayAction::Toggle;
+  else if (action == "pulse")
+    job.action = RelayAction::Pulse;
+  else
+  {
+    request->send(400, "text/plain", "Parâmetro 'action' deve ser on, off, toggle ou pulse.");
+    return;
+  }
+
+  uint32_t relay = RELAY_COUNT;
+  bool valid = parseNumberArg(request, "relays", job.relays) && parseNumberArg(request, "relay", relay) &&
+               parseNumberArg(request, "delay", job.delayMs) && parseNumberArg(request, "period", job.periodMs) &&
+               parseNumberArg(request, "pulse", job.pulseMs);
+  if (relay < RELAY_COUNT)
+    job.relays |= 1u << relay;
+
+  if (!valid || job.relays == 0 || (job.relays & ~ALL_RELAYS_MASK))
+  {
+    request->send(400, "text/plain", "Parâmetros numéricos ou relés inválidos.");
+    return;
+  }
+
+  if (request->hasArg("at"))
+  {
+    int hour, minute;
+    if (sscanf(request->arg("at").c_str(), "%d:%d", &hour, &minute) != 2 || hour < 0 || hour > 23 || minute < 0 ||
+        minute > 59)
+    {
+      request->send(400, "text/plain", "Parâmetro 'at' deve ser HH:MM.");
+      return;
+    }
+    if (!clockSynced())
+    {
+      request->send(503, "text/plain", "Relógio ainda não sincronizado.");
+      return;
+    }
+
+    job.clockMinute = hour * 60 + minute;
+    job.delayMs = msUntilClockMinute(job.clockMinute);
+    if (!request->hasArg("period"))
+      job.periodMs = DAY_MS;
+  }
+
+  int id = addScheduleJob(job);
+  if (id < 0)
+  {
+    request->send(400, "text/plain", "Job inválido ou agenda cheia.");
+    return;
+  }
+
+  logMessage(LogLevel::Info, "Schedule %d: %s 0x%lx", id, relayActionName(job.action), (unsigned long)job.relays);
+  if (job.periodMs != 0 && !saveSchedule())
+    logMessage(LogLevel::Error, "Falha ao gravar a agenda");
+
+  char json[24];
+  snprintf(json, sizeof(json), "{\"id\":%d}", id);
+  request->send(200, "application/json", json);
+}
+
+void handleScheduleRemove(AsyncWebServerRequest *request)
+{
+  uint32_t id = RelayScheduler::CAPACITY;
+  if (!request->hasArg("id") || !parseNumberArg(request, "id", id))
+  {
+    request->send(400, "text/plain", "Parâmetro 'id' é obrigatório.");
+    return;
+  }
+
+  portENTER_CRITICAL(&schedulerMux);
+  bool removed = relayScheduler.remove(id);
+  portEXIT_CRITICAL(&schedulerMux);
+
+  if (!removed)
+  {
+    request->send(404, "text/plain", "Job não encontrado.");
+    return;
+  }
+
+  if (!saveSchedule())
+    logMessage(LogLevel::Error, "Falha ao gravar a agenda");
+  request->send(200, "text/plain", "OK");
+}
+
+// Atualização por HTTP: POST /update?target=firmware|data&size=N&sha256=<hex>[&offset=N]
+// com a imagem (ou o restante dela, a partir de offset) no corpo. GET /update
+// informa o progresso, inclusive o offset para retomar um envio interrompido.
+bool parseSha256(const String &hex, uint8_t digest[32])
+{
+  if (hex.length() != 64)
+    return false;
+
+  for (int i = 0; i < 32; i++)
+  {
+    char byte[3] = {hex[i * 2], hex[i * 2 + 1], '\0'};
+    char *end;
+    digest[i] = strtoul(byte, &end, 16);
+    if (*end != '\0')
+      return false;
+  }
+  return true;
+}
+
+int formatOtaStatus(char *buffer, size_t size, OtaResult result)
+{
+  uint32_t ms = otaStream.elapsedMs();
+  return snprintf(buffer, size,
+                  "{\"target\":\"%s\",\"offset\":%lu,\"size\":%lu,\"active\":%s,\"result\":\"%s\","
+                  "\"ms\":%lu,\"bytesPerSecond\":%lu,\"peakHeap\":%lu}",
+                  otaStream.target() == OtaTarget::Data ? "data" : "firmware", (unsigned long)otaStream.written(),
+                  (unsigned long)otaStream.size(), otaStream.active() ? "true" : "false",
+                  OtaStream::resultName(result), (unsigned long)ms,
+                  (unsigned long)(ms > 0 ? (uint64_t)otaStream.written() * 1000 / ms : 0),
+                  (unsigned long)otaStream.peakHeapUsed());
+}
+
+// Desmonta o LittleFS antes de a partição dele ser sobrescrita. Espera uma
+// gravação do journal/agenda em curso; recusa enquanto houver arquivo sendo servido.
+bool unmountFileSystem()
+{
+  if (fsUpdating)
+    return true;
+  if (openFileResponses > 0)
+    return false;
+
+  xSemaphoreTake(fsMutex, portMAX_DELAY);
+  fsUpdating = true;
+  LittleFS.end();
+  xSemaphoreGive(fsMutex);
+  return true;
+}
+
+// Sessão de dados retomável: a partição já está parcialmente sobrescrita
+bool dataUploadPending()
+{
+  return otaStream.active() && otaStream.target() == OtaTarget::Data;
+}
+
+// Remonta o LittleFS e regrava o estado atual dos relés e da agenda. Sem uma
+// imagem completa (hash recusado, erro de flash, sessão substituída) a partição
+// tem dados parciais: os superblocos são apagados e a montagem formata um
+// LittleFS vazio, em vez de montar uma imagem pela metade.
+void remountFileSystem(bool imageWritten)
+{
+  if (!fsUpdating)
+    return;
+
+  xSemaphoreTake(fsMutex, portMAX_DELAY);
+  if (!imageWritten)
+  {
+    const esp_partition_t *partition =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, NULL);
+    if (partition != NULL)
+      esp_partition_erase_range(partition, 0, 2 * OtaStream::SECTOR_SIZE);
+    logMessage(LogLevel::Error, "Imagem do LittleFS incompleta: formatando");
+  }
+
+  if (!LittleFS.begin(!imageWritten))
+  {
+    xSemaphoreGive(fsMutex);
+    logMessage(LogLevel::Error, "Falha ao montar o LittleFS gravado");
+    return; // Persistência segue suspensa até uma imagem válida
+  }
+
+  for (StaticAsset &asset : staticAssets)
+    asset.etag[0] = '\0';
+
+  uint32_t ignored;
+  relayJournal.restore(ignored);
+  relayJournal.record(relayState.snapshot().mask);
+  fsUpdating = false;
+  xSemaphoreGive(fsMutex);
+
+  if (!saveSchedule())
+    logMessage(LogLevel::Error, "Falha ao gravar a agenda");
+}
+
+// Envio recusado ou interrompido. Com uma sessão de dados retomável o LittleFS
+// segue desmontado, e o journal e a agenda esperando, até a imagem ser
+// concluída ou substituída.
+void releaseOtaRequest()
+{
+  otaRequest = NULL;
+  if (!dataUploadPending())
+    remountFileSystem(false);
+}
+
+// Cada pedaço do corpo vai direto para a flash; o resultado sai em handleUpdate
+void handleUpdateBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
+{
+  if (index == 0)
+  {
+    // Um envio por vez: o corpo de outro envio simultâneo é descartado
+    if (otaRequest != NULL && otaRequest != request)
+      return;
+    otaRequest = request;
+    request->onDisconnect([request]()
+                          {
+                            // Desistiu antes de handleUpdate responder
+                            if (otaRequest == request)
+                              releaseOtaRequest(); });
+
+    uint8_t sha256[32];
+    uint32_t size = 0;
+    uint32_t offset = 0;
+    OtaTarget target = request->arg("target") == "data" ? OtaTarget::Data : OtaTarget::Firmware;
+
+    otaArgsValid = request->hasArg("size") && parseNumberArg(request, "size", size) &&
+                   parseSha256(request->arg("sha256"), sha256) && parseNumberArg(request, "offset", offset);
+    if (!otaArgsValid)
+      return;
+
+    // Só um envio aceito (tamanho, partição e offset válidos) desmonta o LittleFS
+    otaRequestResult = otaStream.begin(target, size, sha256, offset);
+    if (otaRequestResult == OtaResult::Ok && target == OtaTarget::Data && !unmountFileSystem())
+    {
+      otaStream.abort();
+      otaRequestResult = OtaResult::Busy;
+    }
+    if (otaRequestResult == OtaResult::Ok && offset == 0)
+      logMessage(LogLevel::Info, "OTA %s: %lu bytes", target == OtaTarget::Data ? "data" : "firmware",
+                 (unsigned long)size);
+  }
+
+  if (otaRequest == request && otaArgsValid && otaRequestResult == OtaResult::Ok)
+    otaRequestResult = otaStream.write(data, len);
+}
+
+void handleUpdate(AsyncWebServerRequest *request)
+{
+  if (otaRequest != request)
+  {
+    // Sem corpo, ou com outro envio em andamento
+    if (otaRequest != NULL)
+      request->send(503, "text/plain", "Outra atualização em andamento");
+    else
+      request->send(400, "text/plain", "Parâmetros 'size' e 'sha256' (hex) são obrigatórios.");
+    return;
+  }
+
+  if (!otaArgsValid)
+  {
+    releaseOtaRequest();
+    request->send(400, "text/plain", "Parâmetros 'size' e 'sha256' (hex) são obrigatórios.");
+    return;
+  }
+
+  OtaResult result = otaRequestResult;
+  bool done = false;
+  if (result == OtaResult::Ok && otaStream.size() > 0 && otaStream.written() == otaStream.size())
+  {
+    result = otaStream.finish();
+    done = result == OtaResult::Ok;
+  }
+
+  // Imagem de dados gravada: o LittleFS volta com ela. Incompleta, segue
+  // desmontado à espera da retomada; recusada, volta formatado.
+  otaRequest = NULL;
+  if (!dataUploadPending())
+    remountFileSystem(done && otaStream.target() == OtaTarget::Data);
+
+  char json[192];
+  formatOtaStatus(json, sizeof(json), result);
+
+  int code;
+  switch (result)
+  {
+  case OtaResult::Ok:
+    code = 200;
+    break;
+  case OtaResult::BadOffset:
+    code = 409; // Corpo traz "offset" para retomar
+    break;
+  case OtaResult::TooLarge:
+  case OtaResult::Incomplete:
+    code = 400;
+    break;
+  case OtaResult::HashMismatch:
+  case OtaResult::InvalidImage:
+    code = 422;
+    break;
+  case OtaResult::Busy:
+    code = 503;
+    break;
+  default:
+    code = 500;
+    break;
+  }
+  request->send(code, "application/json", json);
+
+  if (result != OtaResult::Ok)
+  {
+    logMessage(LogLevel::Error, "OTA: %s em %lu", OtaStream::resultName(result), (unsigned long)otaStream.written());
+    return;
+  }
+
+  if (done)
+  {
+    uint32_t ms = otaStream.elapsedMs();
+    logMessage(LogLevel::Info, "OTA ok: %lu KB/s, heap +%luB",
+               (unsigned long)(ms > 0 ? otaStream.written() / ms : 0), (unsigned long)otaStream.peakHeapUsed());
+
+    // Firmware novo entra após a resposta chegar ao cliente
+    if (otaStream.target() == OtaTarget::Firmware)
+      request->onDisconnect([]()
+                            { ESP.restart(); });
+  }
+}
+
+void handleGetUpdate(AsyncWebServerRequest *request)
+{
+  char json[192];
+  formatOtaStatus(json, sizeof(json), otaRequestResult);
+  request->send(200, "application/json", json);
+}
+
+void setupServer()
+{
+  server.on("/", HTTP_GET, timedRoute(httpIndexLatency, [](AsyncWebServerRequest *request)
+                                      { serveFile(request, staticAssets[0]); }));
+  server.on("/style.css", HTTP_GET, timedRoute(httpStyleLatency, [](AsyncWebServerRequest *request)
+                                               { serveFile(request, staticAssets[1]); }));
+  server.on("/script.js", HTTP_GET, timedRoute(httpScriptLatency, [](AsyncWebServerRequest *request)
+                                               { serveFile(request, staticAssets[2]); }));
+  server.on("/relay", HTTP_GET, timedRoute(httpRelayLatency, handleRelayControl));
+  server.on("/relays", HTTP_GET, timedRoute(httpRelaysLatency, handleRelayBatch));
+  server.on("/status", HTTP_GET, timedRoute(httpStatusLatency, handleGetRelayStatus));
+  server.on("/logs", HTTP_GET, timedRoute(httpLogsLatency, handleGetLogs));
+  server.on("/boot", HTTP_GET, timedRoute(httpBootLatency, handleGetBoot));
+  server.on("/metrics", HTTP_GET, timedRoute(httpMetricsLatency, handleGetMetrics));
+  // Rotas mais específicas antes: "/schedule" também atende "/schedule/..."
+  server.on("/schedule/add", HTTP_GET, timedRoute(httpScheduleAddLatency, handleScheduleAdd));
+  server.on("/schedule/remove", HTTP_GET, timedRoute(httpScheduleRemoveLatency, handleScheduleRemove));
+  server.on("/schedule", HTTP_GET, timedRoute(httpScheduleLatency, handleGetSchedule));
+  server.on("/update", HTTP_GET, timedRoute(httpUpdateLatency, handleGetUpdate));
+  server.on("/update", HTTP_POST, timedRoute(httpUpdateLatency, handleUpdate), NULL, handleUpdateBody);
+  server.onNotFound([](AsyncWebServerRequest *request)
+                    { request->send(404, "text/plain", "Não encontrado"); });
+
+  events.onConnect(handleEventsConnect);
+  server.addHandler(&events);
+  server.begin();
+}
+
+uint32_t screenEvents(int screen)
+{
+  switch (screen)
+  {
+  case 0:
+    return DISPLAY_EVENT_SCREEN | DISPLAY_EVENT_RELAY;
+  case 1:
+    return DISPLAY_EVENT_SCREEN | DISPLAY_EVENT_NETWORK;
+  case 3:
+    return DISPLAY_EVENT_SCREEN | DISPLAY_EVENT_LOG;
+  default:
+    return DISPLAY_EVENT_SCREEN | DISPLAY_EVENT_TICK;
+  }
+}
+
+// Descarta o quadro retido: o próximo drawScreen redesenha e envia tudo
+void redrawDisplay()
+{
+  renderedScreen = -1;
+  displayFlush.invalidate();
+}
+
+void drawScreen(int screen)
+{
+  uint32_t start = micros();
+
+  if (screen != renderedScreen)
+  {
+    display.clearDisplay();
+    screens[screen]->invalidate();
+    renderedScreen = screen;
+  }
+
+  // Sem widgets alterados não há rasterização nem flush
+  if (screens[screen]->render(display) == 0)
+    return;
+
+  uint32_t drawn = micros();
+  displayFlush.flush();
+  uint32_t flushed = micros();
+
+  frameDrawLatency.record(drawn - start);
+  frameFlushLatency.record(flushed - drawn);
+}
+
+TickType_t displayWaitTicks(int screen)
+{
+  // Acorda no prazo da máquina de estados do botão (debounce, pressionamento longo)
+  unsigned long now = millis();
+  uint32_t wait = buttonInput.nextDeadline(now);
+
+  if (now < splashEndMs && splashEndMs - now < wait)
+    wait = splashEndMs - now;
+
+  if ((screenEvents(screen) & DISPLAY_EVENT_TICK) && INFO_SCREEN_UPDATE_DELAY < wait)
+    wait = INFO_SCREEN_UPDATE_DELAY;
+
+  if (wait == ButtonInput::NO_DEADLINE)
+    return portMAX_DELAY;
+
+  return wait / portTICK_PERIOD_MS + 1;
+}
+
+void taskDisplayAndButton(void *pvParameters)
+{
+  display.setTextSize(1);
+  display.setTextColor(SSD1306_WHITE);
+  display.setTextWrap(false);
+
+  uint32_t events = DISPLAY_EVENT_SCREEN;
+
+  for (;;)
+  {
+    events |= processButtonInput();
+
+    portENTER_CRITICAL(&mux);
+    int screen = currentScreen;
+    portEXIT_CRITICAL(&mux);
+
+    uint32_t eventStart = displayEventStart.exchange(0);
+    bool splash = millis() < splashEndMs; // Splash não bloqueante: eventos ficam pendentes
+
+    if (!splash && (events & screenEvents(screen)))
+    {
+      drawScreen(screen);
+
+      if (eventStart != 0)
+        frameEventLatency.record(micros() - eventStart);
+    }
+
+    uint32_t received = 0;
+    if (xTaskNotifyWait(0, UINT32_MAX, &received, displayWaitTicks(screen)) == pdFALSE)
+      received = DISPLAY_EVENT_TICK;
+    events = (splash ? events : 0) | received;
+  }
+}
+
+// Leva as saídas ao estado comandado; retorna em quantos ms chamar de novo.
+// Uma escrita recusada pelas saídas é repetida em ACTUATOR_RETRY_MS até entrar.
+uint32_t serviceActuator()
+{
+  uint32_t before = relayActuator.outputs();
+  uint32_t wait = relayActuator.update(relayState.snapshot().mask, millis());
+
+  uint32_t after = relayActuator.outputs();
+  if (after != before)
+    relayOutputSwitches.inc(__builtin_popcount(before ^ after));
+
+  uint32_t applied = relayOutputsMask.load();
+  if (after != applied)
+  {
+    bool written = writeRelayOutputs(after);
+    relayOutputsMask = relayOutputs.applied();
+    if (!written && wait > ACTUATOR_RETRY_MS)
+      wait = ACTUATOR_RETRY_MS;
+
+    // O estado MQTT traz as saídas: publica quando elas mudam
+    if (relayOutputsMask.load() != applied && mqttTaskHandle != NULL)
+      xTaskNotifyGive(mqttTaskHandle);
+  }
+  return wait;
+}
+
+// Único escritor das saídas: acorda a cada comando e quando vence o prazo de
+// um relé pendente (janela de coalescência, intervalo mínimo, escalonamento).
+// A primeira passada roda antes de esperar: aplica o estado restaurado no boot.
+void taskActuator(void *pvParameters)
+{
+  for (;;)
+  {
+    uint32_t wait = serviceActuator();
+    ulTaskNotifyTake(pdTRUE, wait == RelayActuator::IDLE ? portMAX_DELAY : wait / portTICK_PERIOD_MS + 1);
+  }
+}
+
+// Mudanças nos relés vão aos clientes SSE. As esperas do /status não passam
+// por aqui: cada uma confere a versão na tarefa do AsyncTCP (StatusPollResponse).
+void taskStatePush(void *pvParameters)
+{
+  for (;;)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    pushRelayState();
+  }
+}
+
+// Persiste o estado dos relés agrupando rajadas de mudanças em um único registro
+void taskJournal(void *pvParameters)
+{
+  for (;;)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    unsigned long firstChange = millis();
+    while (millis() - firstChange < JOURNAL_MAX_DELAY &&
+           ulTaskNotifyTake(pdTRUE, JOURNAL_COALESCE_DELAY / portTICK_PERIOD_MS) > 0)
+    {
+    }
+
+    // Imagem do LittleFS sendo gravada: espera a remontagem. A trava impede
+    // que a desmontagem aconteça no meio de uma gravação.
+    xSemaphoreTake(fsMutex, portMAX_DELAY);
+    while (fsUpdating)
+    {
+      xSemaphoreGive(fsMutex);
+      vTaskDelay(1000 / portTICK_PERIOD_MS);
+      xSemaphoreTake(fsMutex, portMAX_DELAY);
+    }
+
+    bool recorded = relayJournal.record(relayState.snapshot().mask);
+    xSemaphoreGive(fsMutex);
+    if (!recorded)
+      logMessage(LogLevel::Error, "Falha ao gravar o journal dos relés");
+  }
+}
+
+RelaySnapshot readRelayState()
+{
+  return relayState.snapshot();
+}
+
+uint32_t readRelayOutputs()
+{
+  return relayOutputsMask.load();
+}
+
+// Comandos MQTT passam pelo mesmo caminho dos handlers HTTP
+void applyRelayCommand(const RelayCommand &command)
+{
+  RelaySnapshot snap = command.toggle ? applyRelayMask(~relayState.snapshot().mask, command.toggle)
+                                      : applyRelayMask(command.target, command.touch);
+  mqttCommands.inc();
+  logMessage(LogLevel::Info, "MQTT relays: 0x%lx", (unsigned long)snap.mask);
+}
+
+// Mantém o cliente MQTT; mudanças nos relés acordam a tarefa para publicar logo
+void taskMqtt(void *pvParameters)
+{
+  bool wasConnected = false;
+
+  for (;;)
+  {
+    uint32_t wait = mqttLink.service(millis());
+
+    bool connected = mqttLink.connected();
+    if (connected != wasConnected)
+      logMessage(connected ? LogLevel::Info : LogLevel::Warn, "MQTT %s", connected ? "conectado" : "desconectado");
+    wasConnected = connected;
+
+    ulTaskNotifyTake(pdTRUE, wait / portTICK_PERIOD_MS + 1);
+  }
+}
+
+// Avança a timing wheel e dorme até o próximo tick com trabalho (nextStepMs),
+// ou até ser avisada de um job novo ou reagendado; sem jobs, dorme até o aviso
+void taskScheduler(void *pvParameters)
+{
+  ScheduledAction due[RelayScheduler::CAPACITY];
+
+  for (;;)
+  {
+    if (pendingClockJobCount > 0 && clockSynced())
+      armPendingClockJobs();
+
+    bool more = true;
+    while (more)
+    {
+      size_t count;
+      portENTER_CRITICAL(&schedulerMux);
+      more = relayScheduler.step(millis(), due, count);
+      portEXIT_CRITICAL(&schedulerMux);
+
+      for (size_t i = 0; i < count; i++)
+      {
+        applyScheduledAction(due[i]);
+        if (due[i].clockMinute >= 0)
+          retimeClockJob(due[i]);
+      }
+    }
+
+    portENTER_CRITICAL(&schedulerMux);
+    uint32_t wait = relayScheduler.nextStepMs(millis());
+    portEXIT_CRITICAL(&schedulerMux);
+
+    // Jobs com horário aguardando o NTP: confere o relógio a cada segundo
+    if (pendingClockJobCount > 0 && wait > 1000)
+      wait = 1000;
+    ulTaskNotifyTake(pdTRUE, wait == RelayScheduler::IDLE ? portMAX_DELAY : wait / portTICK_PERIOD_MS + 1);
+  }
+}
+
+void setupDisplay()
+{
+  if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS))
+  {
+    logMessage(LogLevel::Error, "Falha na inicialização do display SSD1306");
+    ESP.restart();
+  }
+
+  blitPaged(display, BootLogoPaged, 0, 0, BlitMode::Copy);
+  displayFlush.flush();
+  splashEndMs = millis() + SPLASH_DURATION;
+}
+
+// Relés em estado conhecido (desligados) antes de qualquer outra inicialização.
+// O I2C sobe aqui porque os expansores de relés dividem o barramento com o display.
+// As saídas começam no estado restaurado: um relé ligado antes do reset não
+// é desligado e religado no boot
+void setupRelays(uint32_t restoredMask)
+{
+  Wire.begin(OLED_SDA, OLED_SCL);
+  Wire.setClock(I2C_FREQUENCY);
+
+  relayOutputs.begin(restoredMask);
+  relayOutputsMask = relayOutputs.applied(); // Chip que falhou: o atuador tenta de novo
+  relayActuator.begin(restoredMask, ACTUATOR_MERGE_WINDOW_MS, ACTUATOR_MIN_SWITCH_MS, ACTUATOR_STAGGER_MS);
+}
+
+// Estado dos relés do journal; 0 sem journal válido
+uint32_t restoreRelays()
+{
+  uint32_t restoredMask = 0;
+  if (!relayJournal.restore(restoredMask))
+    return 0;
+
+  restoredMask &= ALL_RELAYS_MASK;
+  applyRelayMask(restoredMask, ALL_RELAYS_MASK);
+  logMessage(LogLevel::Info, "Relays restored: 0x%lx", (unsigned long)restoredMask);
+  return restoredMask;
+}
+
+// Jobs relativos recomeçam a contar do boot; os com horário esperam o NTP
+void restoreSchedule()
+{
+  ScheduleJob jobs[SCHEDULER_MAX_JOBS];
+  size_t count = loadScheduleJobs(LittleFS, "/schedule.bin", jobs, SCHEDULER_MAX_JOBS);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    if (jobs[i].clockMinute >= 0)
+      pendingClockJobs[pendingClockJobCount++] = jobs[i];
+    else if (addScheduleJob(jobs[i]) < 0)
+      logMessage(LogLevel::Error, "Falha ao restaurar job agendado");
+  }
+
+  if (count > 0)
+    logMessage(LogLevel::Info, "Schedule restored: %u jobs", (unsigned)count);
+}
+
+void setupButton()
+{
+  pinMode(BUTTON_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), handleButtonPress, CHANGE);
+}
+
+void setupFileSystem()
+{
+  if (!LittleFS.begin())
+  {
+    logMessage(LogLevel::Error, "Falha ao montar o LittleFS");
+    ESP.restart();
+  }
+  fsMutex = xSemaphoreCreateMutex();
+}
+
+// Eventos de conexão atualizam o cache exibido na tela de rede
+void handleWiFiEvent(WiFiEvent_t event)
+{
+  switch (event)
+  {
+  case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+  case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+  case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+  case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+    networkCache.refresh();
+    notifyDisplay(DISPLAY_EVENT_NETWORK);
+    break;
+  default:
+    break;
+  }
+}
+
+void setupWifi()
+{
+  wifiManager.autoConnect("ESP32-Setup");
+
+  if (WiFi.status() == WL_CONNECTED)
+  {
+    logMessage(LogLevel::Info, "Conectado!");
+    configTzTime(TIME_ZONE, NTP_SERVER); // Para os jobs agendados por horário
+  }
+}
+
+// Controle por UDP: o ack sai no mesmo callback, logo após o comando entrar no estado.
+// Sem log por comando: malhas de controle enviam centenas por segundo.
+void setupUdp()
+{
+  udpControl.begin(RELAY_COUNT, UDP_CONTROL_KEY, applyRelayMask, readRelayOutputs);
+  if (!udp.listen(UDP_CONTROL_PORT))
+  {
+    logMessage(LogLevel::Error, "UDP: falha ao abrir a porta %d", UDP_CONTROL_PORT);
+    return;
+  }
+
+  udp.onPacket([](AsyncUDPPacket &packet)
+               {
+                 uint8_t reply[UdpControl::MAX_ACK_SIZE];
+                 size_t replyLength;
+                 UdpStatus status = udpControl.handle(packet.data(), packet.length(), reply, replyLength);
+
+                 if (status == UdpStatus::Applied)
+                   udpApplied.inc();
+                 else if (status == UdpStatus::Duplicate || status == UdpStatus::Stale)
+                   udpIgnored.inc();
+                 else
+                   udpRejected.inc();
+
+                 if (replyLength > 0)
+                   packet.write(reply, replyLength); });
+
+  logMessage(LogLevel::Info, "UDP: porta %d%s", UDP_CONTROL_PORT, udpControl.authenticated() ? " (HMAC)" : "");
+}
+
+void setupMqtt()
+{
+  if (strlen(MQTT_BROKER) == 0)
+    return;
+
+  // Id a partir dos 3 últimos bytes do MAC: tópicos heltec/heltec-xxxxxx/...
+  snprintf(mqttClientId, sizeof(mqttClientId), "heltec-%06lx", (unsigned long)((ESP.getEfuseMac() >> 24) & 0xFFFFFF));
+  mqttLink.begin(MQTT_BROKER, MQTT_PORT, mqttClientId, MQTT_USER, MQTT_PASSWORD, RELAY_COUNT, readRelayState,
+                 readRelayOutputs, applyRelayCommand);
+  xTaskCreatePinnedToCore(taskMqtt, "Mqtt", 4096, NULL, 1, &mqttTaskHandle, 0);
+}
+
+// Provisionamento WiFi (possivelmente no portal cativo) fora do caminho do boot
+void taskWifi(void *pvParameters)
+{
+  uint32_t start = micros();
+  setupWifi();
+  setupServer();
+  setupUdp();
+  setupMqtt();
+  recordBootPhase("wifi", start);
+  vTaskDelete(NULL);
 }
 
 void setup()
 {
-  Serial.begin(9600);
+  Serial.begin(9600); // Antes da primeira fase: os logs do boot saem todos na serial
+
+  uint32_t start = micros();
   setupFileSystem();
+  recordBootPhase("fs", start);
+
+  // O journal fica no LittleFS: as saídas só são configuradas depois dele
+  start = micros();
+  setupRelays(restoreRelays());
+  recordBootPhase("relays", start);
+
+  start = micros();
+  restoreSchedule();
+  setupButton();
+  recordBootPhase("restore", start);
+
+  start = micros();
   setupDisplay();
-  setupWifi();
-  setupIO();
-  setupServer();
+  networkCache.refresh();
+  WiFi.onEvent(handleWiFiEvent);
+  recordBootPhase("display", start);
 
-  xTaskCreatePinnedToCore(taskDisplayAndButton, "DisplayAndButton", 4096, NULL, 1, NULL, 1); // Núcleo 1
-  xTaskCreatePinnedToCore(taskServer, "Server", 4096, NULL, 1, NULL, 0);                     // Núcleo 0
+  start = micros();
+  bootId = esp_random();
+  xTaskCreatePinnedToCore(taskActuator, "Actuator", 4096, NULL, 2, &actuatorTaskHandle, 1);                 // Núcleo 1
+  xTaskCreatePinnedToCore(taskDisplayAndButton, "DisplayAndButton", 4096, NULL, 1, &displayTaskHandle, 1); // Núcleo 1
+  xTaskCreatePinnedToCore(taskStatePush, "StatePush", 4096, NULL, 1, &statePushTaskHandle, 0); // Núcleo 0
+  xTaskCreatePinnedToCore(taskJournal, "Journal", 4096, NULL, 1, &journalTaskHandle, 0);         // Núcleo 0
+  xTaskCreatePinnedToCore(taskScheduler, "Scheduler", 4096, NULL, 1, &schedulerTaskHandle, 0);   // Núcleo 0
+  xTaskCreatePinnedToCore(taskWifi, "WiFi", 8192, NULL, 1, NULL, 0);                             // Núcleo 0
+  recordBootPhase("tasks", start);
 }
 
 void loop()
@@ -0,0 +1,193 @@
+#include <metrics.h>
+#include <stdio.h>
+#include <string.h>
+
+Metric *Metric::head = nullptr;
+Metric *Metric::tail = nullptr;
+
+const uint32_t LatencyHistogram::BOUNDS_US[METRICS_BUCKET_COUNT - 1] = {
+    50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000};
+
+// Os mesmos limites em segundos, como o Prometheus espera
+static const char *const BOUNDS_LABEL[METRICS_BUCKET_COUNT] = {
+    "0.00005", "0.0001", "0.00025", "0.0005", "0.001", "0.0025", "0.005",
+    "0.01", "0.025", "0.05", "0.1", "0.25", "1", "+Inf"};
+
+Metric::Metric(const char *name, const char *help, const char *labels)
+    : name(name), help(help), labels(labels), next(nullptr)
+{
+  // Família já registrada: entra logo após a última métrica dela, para o
+  // HELP/TYPE sair uma vez só e as amostras da família ficarem contíguas
+  Metric *after = tail;
+  for (Metric *metric = head; metric != nullptr; metric = metric->next)
+  {
+    if (strcmp(metric->name, name) == 0)
+      after = metric;
+  }
+
+  if (after == nullptr)
+  {
+    head = this;
+  }
+  else
+  {
+    next = after->next;
+    after->next = this;
+  }
+  if (after == tail)
+    tail = this;
+}
+
+static int fitted(int len, size_t size)
+{
+  return len >= 0 && (size_t)len < size ? len : -1;
+}
+
+int Metric::formatHeader(uint8_t line, const char *type, char *buffer, size_t size) const
+{
+  if (line == 0)
+    return fitted(snprintf(buffer, size, "# HELP %s %s\n", name, help), size);
+  return fitted(snprintf(buffer, size, "# TYPE %s %s\n", name, type), size);
+}
+
+int Metric::formatSample(const char *suffix, const char *value, char *buffer, size_t size,
+                         const char *extraLabel) const
+{
+  const char *separator = labels != nullptr && extraLabel != nullptr ? "," : "";
+
+  if (labels == nullptr && extraLabel == nullptr)
+    return fitted(snprintf(buffer, size, "%s%s %s\n", name, suffix, value), size);
+
+  return fitted(snprintf(buffer, size, "%s%s{%s%s%s} %s\n", name, suffix, labels != nullptr ? labels : "",
+                         separator, extraLabel != nullptr ? extraLabel : "", value),
+                size);
+}
+
+int Counter::formatLine(uint8_t line, char *buffer, size_t size) const
+{
+  if (line < 2)
+    return formatHeader(line, "counter", buffer, size);
+  if (line > 2)
+    return 0;
+
+  char value[12];
+  snprintf(value, sizeof(value), "%lu", (unsigned long)get());
+  return formatSample("", value, buffer, size);
+}
+
+int Gauge::formatLine(uint8_t line, char *buffer, size_t size) const
+{
+  if (line < 2)
+    return formatHeader(line, "gauge", buffer, size);
+  if (line > 2)
+    return 0;
+
+  char value[12];
+  snprintf(value, sizeof(value), "%lu", (unsigned long)read());
+  return formatSample("", value, buffer, size);
+}
+
+void LatencyHistogram::record(uint32_t us)
+{
+  int i = 0;
+  while (i < METRICS_BUCKET_COUNT - 1 && us > BOUNDS_US[i])
+    i++;
+
+  buckets[i].fetch_add(1, std::memory_order_relaxed);
+  sum.fetch_add(us, std::memory_order_relaxed);
+}
+
+uint32_t LatencyHistogram::count() const
+{
+  uint32_t total = 0;
+  for (int i = 0; i < METRICS_BUCKET_COUNT; i++)
+    total += buckets[i].load(std::memory_order_relaxed);
+  return total;
+}
+
+uint32_t LatencyHistogram::percentileUs(uint8_t p) const
+{
+  uint32_t counts[METRICS_BUCKET_COUNT];
+  uint32_t total = 0;
+  for (int i = 0; i < METRICS_BUCKET_COUNT; i++)
+  {
+    counts[i] = buckets[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+
+  if (total == 0)
+    return 0;
+
+  uint32_t rank = (uint32_t)(((uint64_t)total * p + 99) / 100); // Posição do percentil, arredondada para cima
+  uint32_t cumulative = 0;
+  for (int i = 0; i < METRICS_BUCKET_COUNT - 1; i++)
+  {
+    cumulative += counts[i];
+    if (cumulative >= rank)
+      return BOUNDS_US[i];
+  }
+  return UINT32_MAX;
+}
+
+// Linhas: HELP, TYPE, um bucket cumulativo por limite, _sum e _count
+int LatencyHistogram::formatLine(uint8_t line, char *buffer, size_t size) const
+{
+  if (line < 2)
+    return formatHeader(line, "histogram", buffer, size);
+
+  char value[24];
+  uint8_t bucket = line - 2;
+
+  if (bucket < METRICS_BUCKET_COUNT)
+  {
+    uint32_t cumulative = 0;
+    for (int i = 0; i <= bucket; i++)
+      cumulative += buckets[i].load(std::memory_order_relaxed);
+
+    char le[16];
+    snprintf(le, sizeof(le), "le=\"%s\"", BOUNDS_LABEL[bucket]);
+    snprintf(value, sizeof(value), "%lu", (unsigned long)cumulative);
+    return formatSample("_bucket", value, buffer, size, le);
+  }
+
+  if (bucket == METRICS_BUCKET_COUNT)
+  {
+    uint64_t us = sumUs();
+    snprintf(value, sizeof(value), "%lu.%06lu", (unsigned long)(us / 1000000), (unsigned long)(us % 1000000));
+    return formatSample("_sum", value, buffer, size);
+  }
+
+  if (bucket == METRICS_BUCKET_COUNT + 1)
+  {
+    snprintf(value, sizeof(value), "%lu", (unsigned long)count());
+    return formatSample("_count", value, buffer, size);
+  }
+
+  return 0;
+}
+
+size_t MetricsExporter::read(char *buffer, size_t size)
+{
+  size_t written = 0;
+
+  while (metric != nullptr)
+  {
+    int len = metric->formatLine(line, buffer + written, size - written);
+    if (len < 0)
+      break; // Não coube: continua no próximo read
+
+    if (len == 0)
+    {
+      // HELP e TYPE só uma vez por família (mesmo nome, labels diferentes)
+      const Metric *previous = metric;
+      metric = metric->next;
+      line = metric != nullptr && strcmp(previous->name, metric->name) == 0 ? 2 : 0;
+      continue;
+    }
+
+    written += len;
+    line++;
+  }
+
+  return written;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#define METRICS_BUCKET_COUNT 14 // Inclui o +Inf
+
+// Métrica exportada em /metrics. Todas as instâncias se registram numa lista
+// na construção; devem ser globais (vivem até o reset). Métricas com o mesmo
+// nome e labels diferentes entram juntas na lista, em qualquer ordem de declaração.
+class Metric
+{
+public:
+  Metric(const char *name, const char *help, const char *labels);
+
+  // Escreve a linha "line" no formato texto do Prometheus (0 = HELP, 1 = TYPE).
+  // Retorna o tamanho, 0 se a métrica não tem mais linhas ou -1 se não coube.
+  virtual int formatLine(uint8_t line, char *buffer, size_t size) const = 0;
+
+  static const Metric *first() { return head; }
+
+  const char *const name;
+  const char *const help;
+  const char *const labels; // Ex.: route="/status", ou NULL
+  Metric *next;
+
+protected:
+  int formatHeader(uint8_t line, const char *type, char *buffer, size_t size) const;
+  int formatSample(const char *suffix, const char *value, char *buffer, size_t size,
+                   const char *extraLabel = nullptr) const;
+
+private:
+  static Metric *head;
+  static Metric *tail;
+};
+
+class Counter : public Metric
+{
+public:
+  Counter(const char *name, const char *help, const char *labels = nullptr) : Metric(name, help, labels) {}
+
+  void inc(uint32_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+  uint32_t get() const { return value.load(std::memory_order_relaxed); }
+
+  int formatLine(uint8_t line, char *buffer, size_t size) const override;
+
+private:
+  std::atomic<uint32_t> value{0};
+};
+
+// Valor lido só na exportação (heap, pilha das tarefas)
+class Gauge : public Metric
+{
+public:
+  typedef uint32_t (*ReadFunction)();
+
+  Gauge(const char *name, const char *help, const char *labels, ReadFunction read)
+      : Metric(name, help, labels), read(read) {}
+
+  int formatLine(uint8_t line, char *buffer, size_t size) const override;
+
+private:
+  ReadFunction read;
+};
+
+// Histograma de latências com buckets fixos (50 us a 1 s). record() só faz
+// incrementos atômicos: pode ser chamado de qualquer tarefa, sem alocação.
+class LatencyHistogram : public Metric
+{
+public:
+  static const uint32_t BOUNDS_US[METRICS_BUCKET_COUNT - 1];
+
+  LatencyHistogram(const char *name, const char *help, const char *labels = nullptr) : Metric(name, help, labels) {}
+
+  void record(uint32_t us);
+
+  uint32_t count() const;
+  uint64_t sumUs() const { return sum.load(std::memory_order_relaxed); }
+
+  // Limite superior do bucket que contém o percentil p (0 se vazio,
+  // UINT32_MAX se cair no +Inf)
+  uint32_t percentileUs(uint8_t p) const;
+
+  int formatLine(uint8_t line, char *buffer, size_t size) const override;
+
+private:
+  std::atomic<uint32_t> buckets[METRICS_BUCKET_COUNT] = {};
+  std::atomic<uint64_t> sum{0};
+};
+
+// Percorre as métricas registradas gerando o texto do Prometheus em partes,
+// sempre com linhas inteiras (para respostas chunked). Ponteiro + linha: cabe
+// na captura do filler sem alocar.
+class MetricsExporter
+{
+public:
+  MetricsExporter() : metric(Metric::first()) {}
+
+  // Preenche o buffer com as próximas linhas; retorna 0 ao terminar
+  size_t read(char *buffer, size_t size);
+
+private:
+  const Metric *metric;
+  uint8_t line = 0;
+};
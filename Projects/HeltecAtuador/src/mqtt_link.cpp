@@ -0,0 +1,157 @@
+#include <mqtt_link.h>
+
+bool parseRelayCommand(const char *topic, const uint8_t *payload, size_t length, uint8_t relayCount,
+                       RelayCommand &command)
+{
+  char text[24];
+  if (length >= sizeof(text))
+    return false;
+  memcpy(text, payload, length);
+  text[length] = '\0';
+
+  const uint32_t all = relayCount >= 32 ? UINT32_MAX : (1u << relayCount) - 1;
+  command = {0, 0, 0};
+
+  if (strcmp(topic, "relays/set") == 0)
+  {
+    char *end;
+    command.target = strtoul(text, &end, 0);
+    if (end == text)
+      return false;
+
+    command.touch = all;
+    if (*end == ' ')
+    {
+      char *touch = end + 1;
+      command.touch = strtoul(touch, &end, 0);
+      if (end == touch)
+        return false;
+    }
+    return *end == '\0' && !((command.target | command.touch) & ~all);
+  }
+
+  unsigned relay;
+  int consumed = 0;
+  if (sscanf(topic, "relay/%u/set%n", &relay, &consumed) != 1 || consumed == 0 || topic[consumed] != '\0' ||
+      relay >= relayCount)
+    return false;
+
+  uint32_t bit = 1u << relay;
+  if (strcmp(text, "on") == 0)
+    command = {bit, bit, 0};
+  else if (strcmp(text, "off") == 0)
+    command = {0, bit, 0};
+  else if (strcmp(text, "toggle") == 0)
+    command = {0, 0, bit};
+  else
+    return false;
+  return true;
+}
+
+void MqttLink::begin(const char *host, uint16_t port, const char *clientId, const char *user, const char *password,
+                     uint8_t relayCount, StateReader readState, OutputsReader readOutputs, CommandHandler handler)
+{
+  this->clientId = clientId;
+  this->user = user;
+  this->password = password;
+  this->relayCount = relayCount;
+  this->readState = readState;
+  this->readOutputs = readOutputs;
+  this->handler = handler;
+
+  baseLength = snprintf(base, sizeof(base), "%s/%s/", MQTT_TOPIC_PREFIX, clientId);
+  snprintf(stateTopic, sizeof(stateTopic), "%sstate", base);
+  snprintf(statusTopic, sizeof(statusTopic), "%sstatus", base);
+  snprintf(relayTopic, sizeof(relayTopic), "%srelay/+/set", base);
+  snprintf(batchTopic, sizeof(batchTopic), "%srelays/set", base);
+
+  client.setServer(host, port);
+  client.setCallback([this](char *topic, uint8_t *payload, unsigned int length)
+                     { handleMessage(topic, payload, length); });
+}
+
+bool MqttLink::connect()
+{
+  if (!client.connect(clientId, user, password, statusTopic, 1, true, "offline"))
+    return false;
+
+  client.publish(statusTopic, "online", true);
+  client.subscribe(relayTopic);
+  client.subscribe(batchTopic);
+  return true;
+}
+
+uint32_t MqttLink::service(uint32_t nowMs)
+{
+  if (!client.connected())
+  {
+    if ((int32_t)(nowMs - nextAttemptMs) < 0)
+      return nextAttemptMs - nowMs;
+
+    if (!connect())
+    {
+      uint32_t wait = backoffMs;
+      nextAttemptMs = nowMs + wait;
+      backoffMs = backoffMs * 2 < BACKOFF_MAX_MS ? backoffMs * 2 : BACKOFF_MAX_MS;
+      return wait;
+    }
+
+    // Broker pode ter perdido o retido: republica o estado a cada conexão
+    backoffMs = BACKOFF_MIN_MS;
+    statePublished = false;
+    connects++;
+  }
+
+  client.loop(); // Entrega os comandos recebidos em handleMessage
+
+  RelaySnapshot state = readState();
+  uint32_t outputs = readOutputs();
+  if (statePublished && state.version == publishedVersion && outputs == publishedOutputs)
+  {
+    pending = false;
+    return POLL_MS;
+  }
+
+  // Primeira mudança abre a janela; as seguintes entram no mesmo publish
+  if (statePublished)
+  {
+    if (!pending)
+    {
+      pending = true;
+      pendingSinceMs = nowMs;
+    }
+    uint32_t elapsed = nowMs - pendingSinceMs;
+    if (elapsed < MQTT_BATCH_WINDOW_MS)
+      return MQTT_BATCH_WINDOW_MS - elapsed < POLL_MS ? MQTT_BATCH_WINDOW_MS - elapsed : POLL_MS;
+  }
+
+  if (publishState(state, outputs))
+    pending = false;
+  return POLL_MS;
+}
+
+bool MqttLink::publishState(const RelaySnapshot &state, uint32_t outputs)
+{
+  char payload[64];
+  snprintf(payload, sizeof(payload), "{\"s\":%lu,\"v\":%lu,\"o\":%lu,\"n\":%u}", (unsigned long)state.mask,
+           (unsigned long)state.version, (unsigned long)outputs, relayCount);
+
+  if (!client.publish(stateTopic, payload, true))
+    return false;
+
+  statePublished = true;
+  publishedVersion = state.version;
+  publishedOutputs = outputs;
+  publishes++;
+  return true;
+}
+
+void MqttLink::handleMessage(char *topic, uint8_t *payload, unsigned int length)
+{
+  if (strncmp(topic, base, baseLength) != 0)
+    return;
+
+  RelayCommand command;
+  if (parseRelayCommand(topic + baseLength, payload, length, relayCount, command))
+    handler(command);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <PubSubClient.h>
+#include <relay_state.h>
+
+#ifndef MQTT_TOPIC_PREFIX
+#define MQTT_TOPIC_PREFIX "heltec"
+#endif
+#ifndef MQTT_BATCH_WINDOW_MS
+#define MQTT_BATCH_WINDOW_MS 10 // Mudanças dentro da janela saem em um único publish
+#endif
+
+// Comando de relés: estado "target" nos relés de "touch" e inversão dos de "toggle"
+struct RelayCommand
+{
+  uint32_t target;
+  uint32_t touch;
+  uint32_t toggle;
+};
+
+// Interpreta um comando pelo tópico (sem a base) e payload:
+//   relay/<n>/set  "on" | "off" | "toggle"   (n a partir de 0, como no /relay)
+//   relays/set     "<mask> [<touch>]"        (como no /relays)
+bool parseRelayCommand(const char *topic, const uint8_t *payload, size_t length, uint8_t relayCount,
+                       RelayCommand &command);
+
+// Cliente MQTT dos relés, com base <prefixo>/<id>/:
+//   state   retido, {"s":mask,"v":versão,"o":saídas,"n":relés}, publicado quando o
+//           estado comandado (s) ou o aplicado nas saídas físicas (o) muda
+//   status  retido, "online" / "offline" (LWT)
+//   relay/+/set e relays/set  comandos
+// Mudanças dentro de MQTT_BATCH_WINDOW_MS viram um único publish.
+class MqttLink
+{
+public:
+  static const uint32_t POLL_MS = 10;
+  static const uint32_t BACKOFF_MIN_MS = 1000;
+  static const uint32_t BACKOFF_MAX_MS = 60000;
+
+  typedef void (*CommandHandler)(const RelayCommand &command);
+  typedef RelaySnapshot (*StateReader)();
+  typedef uint32_t (*OutputsReader)();
+
+  MqttLink(Client &network) : client(network) {}
+
+  void begin(const char *host, uint16_t port, const char *clientId, const char *user, const char *password,
+             uint8_t relayCount, StateReader readState, OutputsReader readOutputs, CommandHandler handler);
+
+  // Mantém a conexão (reconexão com backoff exponencial), entrega os comandos
+  // recebidos e publica o estado pendente. Retorna em quantos ms chamar de novo.
+  uint32_t service(uint32_t nowMs);
+
+  bool connected() { return client.connected(); }
+  uint32_t publishCount() const { return publishes; }
+  uint32_t connectCount() const { return connects; }
+
+  PubSubClient &pubSub() { return client; }
+
+private:
+  bool connect();
+  void handleMessage(char *topic, uint8_t *payload, unsigned int length);
+  bool publishState(const RelaySnapshot &state, uint32_t outputs);
+
+  PubSubClient client;
+  StateReader readState = NULL;
+  OutputsReader readOutputs = NULL;
+  CommandHandler handler = NULL;
+  uint8_t relayCount = 0;
+  const char *clientId = NULL;
+  const char *user = NULL;
+  const char *password = NULL;
+
+  char base[48];
+  size_t baseLength = 0;
+  char stateTopic[64];
+  char statusTopic[64];
+  char relayTopic[64];
+  char batchTopic[64];
+
+  bool statePublished = false;
+  uint32_t publishedVersion = 0;
+  uint32_t publishedOutputs = 0;
+  bool pending = false;
+  uint32_t pendingSinceMs = 0;
+  uint32_t backoffMs = BACKOFF_MIN_MS;
+  uint32_t nextAttemptMs = 0;
+  uint32_t publishes = 0;
+  uint32_t connects = 0;
+};
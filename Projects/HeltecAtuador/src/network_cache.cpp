@@ -0,0 +1,34 @@
+#include <network_cache.h>
+#include <WiFi.h>
+
+static void formatIP(char *buffer, size_t size, const IPAddress &ip)
+{
+  snprintf(buffer, size, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+}
+
+void NetworkCache::refresh()
+{
+  // Consulta o driver fora da seção crítica; só a cópia fica protegida
+  NetworkSnapshot next = {};
+  next.connected = WiFi.status() == WL_CONNECTED;
+  snprintf(next.mac, sizeof(next.mac), "%s", WiFi.macAddress().c_str());
+
+  if (next.connected)
+  {
+    snprintf(next.ssid, sizeof(next.ssid), "%s", WiFi.SSID().c_str());
+    formatIP(next.ip, sizeof(next.ip), WiFi.localIP());
+    formatIP(next.gateway, sizeof(next.gateway), WiFi.gatewayIP());
+  }
+
+  portENTER_CRITICAL(&mux);
+  snapshot = next;
+  portEXIT_CRITICAL(&mux);
+  ver.fetch_add(1, std::memory_order_release);
+}
+
+void NetworkCache::read(NetworkSnapshot &out)
+{
+  portENTER_CRITICAL(&mux);
+  out = snapshot;
+  portEXIT_CRITICAL(&mux);
+}
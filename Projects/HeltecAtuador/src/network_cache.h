@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Dados de rede exibidos na tela, já formatados
+struct NetworkSnapshot
+{
+  bool connected;
+  char ssid[33];
+  char ip[16];
+  char gateway[16];
+  char mac[18];
+};
+
+// Cache dos dados de rede. É atualizado pelos eventos do WiFi (conexão,
+// IP obtido/perdido), então a tela não consulta o driver a cada quadro.
+class NetworkCache
+{
+public:
+  // Relê os valores do driver WiFi e incrementa a versão
+  void refresh();
+
+  void read(NetworkSnapshot &out);
+
+  uint32_t version() const { return ver.load(std::memory_order_acquire); }
+
+private:
+  NetworkSnapshot snapshot = {};
+  std::atomic<uint32_t> ver{0};
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+};
@@ -0,0 +1,141 @@
+#include <ota_stream.h>
+#include <esp_ota_ops.h>
+
+OtaResult OtaStream::begin(OtaTarget target, size_t size, const uint8_t sha256[32], size_t offset)
+{
+  if (offset != 0)
+  {
+    // Retomada: mesma imagem, a partir do que já foi recebido
+    if (!session || target != sessionTarget || size != imageSize || memcmp(sha256, expected, 32) != 0 ||
+        offset != received)
+      return OtaResult::BadOffset;
+    return OtaResult::Ok;
+  }
+
+  abort();
+
+  partition = target == OtaTarget::Firmware
+                  ? esp_ota_get_next_update_partition(NULL)
+                  : esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, NULL);
+  if (partition == NULL)
+    return OtaResult::NoPartition;
+  if (size == 0 || size > partition->size)
+    return OtaResult::TooLarge;
+
+  session = true;
+  sessionTarget = target;
+  imageSize = size;
+  received = 0;
+  flushed = 0;
+  memcpy(expected, sha256, sizeof(expected));
+  mbedtls_sha256_init(&sha);
+  mbedtls_sha256_starts(&sha, 0);
+  startMs = lastWriteMs = millis();
+  heapAtStart = minFreeHeap = ESP.getFreeHeap();
+  return OtaResult::Ok;
+}
+
+bool OtaStream::flushSector()
+{
+  size_t length = received - flushed;
+  if (length == 0)
+    return true;
+
+  if (esp_partition_erase_range(partition, flushed, SECTOR_SIZE) != ESP_OK ||
+      esp_partition_write(partition, flushed, sector, length) != ESP_OK)
+    return false;
+
+  flushed += length;
+  return true;
+}
+
+OtaResult OtaStream::write(const uint8_t *data, size_t length)
+{
+  if (!session)
+    return OtaResult::BadOffset;
+  if (received + length > imageSize)
+    return OtaResult::TooLarge;
+
+  mbedtls_sha256_update(&sha, data, length);
+
+  while (length > 0)
+  {
+    size_t used = received - flushed;
+    size_t chunk = SECTOR_SIZE - used < length ? SECTOR_SIZE - used : length;
+    memcpy(sector + used, data, chunk);
+    received += chunk;
+    data += chunk;
+    length -= chunk;
+
+    if (received - flushed == SECTOR_SIZE && !flushSector())
+    {
+      abort();
+      return OtaResult::FlashError;
+    }
+  }
+
+  uint32_t freeHeap = ESP.getFreeHeap();
+  if (freeHeap < minFreeHeap)
+    minFreeHeap = freeHeap;
+  lastWriteMs = millis();
+  return OtaResult::Ok;
+}
+
+OtaResult OtaStream::finish()
+{
+  if (!session)
+    return OtaResult::BadOffset;
+  if (received != imageSize)
+    return OtaResult::Incomplete;
+
+  if (!flushSector())
+  {
+    abort();
+    return OtaResult::FlashError;
+  }
+
+  uint8_t digest[32];
+  mbedtls_sha256_finish(&sha, digest);
+  mbedtls_sha256_free(&sha);
+  session = false;
+
+  if (memcmp(digest, expected, sizeof(digest)) != 0)
+    return OtaResult::HashMismatch;
+
+  if (sessionTarget == OtaTarget::Firmware && esp_ota_set_boot_partition(partition) != ESP_OK)
+    return OtaResult::InvalidImage;
+
+  return OtaResult::Ok;
+}
+
+void OtaStream::abort()
+{
+  if (session)
+    mbedtls_sha256_free(&sha);
+  session = false;
+}
+
+const char *OtaStream::resultName(OtaResult result)
+{
+  switch (result)
+  {
+  case OtaResult::Ok:
+    return "ok";
+  case OtaResult::BadOffset:
+    return "bad_offset";
+  case OtaResult::TooLarge:
+    return "too_large";
+  case OtaResult::NoPartition:
+    return "no_partition";
+  case OtaResult::FlashError:
+    return "flash_error";
+  case OtaResult::Incomplete:
+    return "incomplete";
+  case OtaResult::HashMismatch:
+    return "hash_mismatch";
+  case OtaResult::Busy:
+    return "busy";
+  default:
+    return "invalid_image";
+  }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <mbedtls/sha256.h>
+
+enum class OtaTarget : uint8_t
+{
+  Firmware, // Partição OTA inativa (ota_0/ota_1)
+  Data      // Imagem do LittleFS (partição "data")
+};
+
+enum class OtaResult : uint8_t
+{
+  Ok,
+  BadOffset,    // Offset diferente do já recebido: retomar de written()
+  TooLarge,     // Imagem maior que a partição ou que o tamanho declarado
+  NoPartition,
+  FlashError,
+  Incomplete,   // finish() antes de receber o tamanho declarado
+  HashMismatch,
+  InvalidImage, // Recusada pelo esp_ota_set_boot_partition
+  Busy          // Destino em uso (LittleFS com arquivos sendo servidos)
+};
+
+// Grava uma imagem direto na partição de destino, em setores de 4 KB, sem
+// manter a imagem em memória. Cada setor é apagado só quando vai ser escrito:
+// operações de flash pausam o cache, e pausas curtas mantêm relés e display
+// respondendo durante o envio. O SHA-256 é calculado à medida que os dados
+// chegam; uma sessão interrompida pode ser retomada (no mesmo boot) a partir
+// de written() com os mesmos tamanho e hash.
+class OtaStream
+{
+public:
+  static const size_t SECTOR_SIZE = 4096;
+
+  // Offset 0 inicia uma nova sessão; outro offset retoma a sessão atual
+  OtaResult begin(OtaTarget target, size_t size, const uint8_t sha256[32], size_t offset);
+
+  // Grava o próximo trecho da imagem (a partir de written())
+  OtaResult write(const uint8_t *data, size_t length);
+
+  // Grava o setor pendente, confere o hash e, para firmware, ativa a partição no próximo boot
+  OtaResult finish();
+
+  void abort();
+
+  bool active() const { return session; }
+  OtaTarget target() const { return sessionTarget; }
+  size_t written() const { return received; }
+  size_t size() const { return imageSize; }
+  uint32_t elapsedMs() const { return lastWriteMs - startMs; }
+
+  // Maior consumo de heap observado durante a sessão, em bytes
+  uint32_t peakHeapUsed() const { return heapAtStart - minFreeHeap; }
+
+  static const char *resultName(OtaResult result);
+
+private:
+  bool flushSector();
+
+  const esp_partition_t *partition = NULL;
+  bool session = false;
+  OtaTarget sessionTarget = OtaTarget::Firmware;
+  size_t imageSize = 0;
+  size_t received = 0;
+  size_t flushed = 0; // Bytes já gravados na flash (múltiplo de SECTOR_SIZE, exceto no fim)
+  uint8_t expected[32];
+  mbedtls_sha256_context sha;
+  uint32_t startMs = 0;
+  uint32_t lastWriteMs = 0;
+  uint32_t heapAtStart = 0;
+  uint32_t minFreeHeap = 0;
+  uint8_t sector[SECTOR_SIZE];
+};
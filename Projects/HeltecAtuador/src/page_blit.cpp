@@ -0,0 +1,87 @@
+#include <page_blit.h>
+
+// Combina uma faixa de bytes de uma página do bitmap em uma página do
+// framebuffer; "mask" marca as linhas do destino cobertas pelo bitmap
+template <BlitMode MODE>
+static void combineRow(uint8_t *dst, const uint8_t *src, int16_t columns, int8_t shift, uint8_t mask)
+{
+  if (MODE == BlitMode::Copy && shift == 0 && mask == 0xFF)
+  {
+    memcpy(dst, src, columns);
+    return;
+  }
+
+  for (int16_t i = 0; i < columns; i++)
+  {
+    uint8_t bits = (shift >= 0 ? src[i] << shift : src[i] >> -shift) & mask;
+    if (MODE == BlitMode::Set)
+      dst[i] |= bits;
+    else if (MODE == BlitMode::Clear)
+      dst[i] &= ~bits;
+    else
+      dst[i] = (dst[i] & ~mask) | bits;
+  }
+}
+
+template <BlitMode MODE>
+static void blitPages(uint8_t *buffer, int16_t bufferWidth, int16_t bufferPages, const PagedBitmap &bitmap,
+                      int16_t x, int16_t y, int16_t first, int16_t columns)
+{
+  const int8_t shift = y & 7;
+  const int16_t topPage = y >> 3; // Arredonda para baixo também com y negativo
+
+  for (int16_t p = 0; p < bitmap.pages(); p++)
+  {
+    const uint8_t *src = bitmap.data + p * bitmap.width + first;
+    int rows = bitmap.height - p * 8;
+    uint8_t rowMask = rows >= 8 ? 0xFF : (1 << rows) - 1;
+    int16_t page = topPage + p;
+
+    uint8_t lowMask = rowMask << shift;
+    if (page >= 0 && page < bufferPages && lowMask != 0)
+      combineRow<MODE>(buffer + page * bufferWidth + x + first, src, columns, shift, lowMask);
+
+    // Linhas que passam para a página seguinte quando y não é alinhado
+    uint8_t highMask = shift != 0 ? rowMask >> (8 - shift) : 0;
+    if (page + 1 >= 0 && page + 1 < bufferPages && highMask != 0)
+      combineRow<MODE>(buffer + (page + 1) * bufferWidth + x + first, src, columns, shift - 8, highMask);
+  }
+}
+
+void blitPaged(uint8_t *buffer, int16_t bufferWidth, int16_t bufferHeight,
+               const PagedBitmap &bitmap, int16_t x, int16_t y, BlitMode mode)
+{
+  int16_t first = x < 0 ? -x : 0;
+  int16_t end = x + bitmap.width > bufferWidth ? bufferWidth - x : bitmap.width;
+  if (first >= end)
+    return;
+
+  switch (mode)
+  {
+  case BlitMode::Set:
+    blitPages<BlitMode::Set>(buffer, bufferWidth, bufferHeight / 8, bitmap, x, y, first, end - first);
+    break;
+  case BlitMode::Clear:
+    blitPages<BlitMode::Clear>(buffer, bufferWidth, bufferHeight / 8, bitmap, x, y, first, end - first);
+    break;
+  case BlitMode::Copy:
+    blitPages<BlitMode::Copy>(buffer, bufferWidth, bufferHeight / 8, bitmap, x, y, first, end - first);
+    break;
+  }
+}
+
+void blitPaged(Adafruit_GFX &gfx, const PagedBitmap &bitmap, int16_t x, int16_t y, BlitMode mode)
+{
+  for (int16_t row = 0; row < bitmap.height; row++)
+  {
+    const uint8_t *src = bitmap.data + (row / 8) * bitmap.width;
+    uint8_t bit = 1 << (row & 7);
+    for (int16_t col = 0; col < bitmap.width; col++)
+    {
+      if (src[col] & bit)
+        gfx.drawPixel(x + col, y + row, mode == BlitMode::Clear ? 0 : 1);
+      else if (mode == BlitMode::Copy)
+        gfx.drawPixel(x + col, y + row, 0);
+    }
+  }
+}
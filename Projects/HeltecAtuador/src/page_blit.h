@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Adafruit_SSD1306.h>
+
+// Bitmap no formato nativo do SSD1306: páginas de 8 linhas, um byte por
+// coluna, bit 0 na linha de cima. Gerado por convert_images.py (images_paged.h).
+struct PagedBitmap
+{
+  uint8_t width;
+  uint8_t height;
+  const uint8_t *data; // pages() páginas de width bytes; bits além de height zerados
+
+  constexpr uint8_t pages() const { return (height + 7) / 8; }
+};
+
+enum class BlitMode : uint8_t
+{
+  Set,   // Acende os pixels do bitmap (drawBitmap com cor 1)
+  Clear, // Apaga os pixels do bitmap (drawBitmap com cor 0)
+  Copy   // Substitui o retângulo inteiro do bitmap
+};
+
+// Combina o bitmap no framebuffer uma coluna de bytes por vez. Com y múltiplo
+// de 8 cada byte cai inteiro em uma página (memcpy no modo Copy); senão é
+// dividido entre duas páginas por deslocamento. Recorta nas bordas.
+void blitPaged(uint8_t *buffer, int16_t bufferWidth, int16_t bufferHeight,
+               const PagedBitmap &bitmap, int16_t x, int16_t y, BlitMode mode);
+
+inline void blitPaged(Adafruit_SSD1306 &display, const PagedBitmap &bitmap, int16_t x, int16_t y, BlitMode mode)
+{
+  blitPaged(display.getBuffer(), display.width(), display.height(), bitmap, x, y, mode);
+}
+
+// Qualquer outro destino (sem framebuffer acessível): pixel a pixel por drawPixel
+void blitPaged(Adafruit_GFX &gfx, const PagedBitmap &bitmap, int16_t x, int16_t y, BlitMode mode);
@@ -0,0 +1,69 @@
+#include <relay_actuator.h>
+
+void RelayActuator::begin(uint32_t outputs, uint32_t mergeWindowMs, uint32_t minSwitchMs, uint32_t staggerMs)
+{
+  physical = outputs;
+  pending = 0;
+  switched = 0;
+  turnedOn = false;
+  this->mergeWindowMs = mergeWindowMs;
+  this->minSwitchMs = minSwitchMs;
+  this->staggerMs = staggerMs;
+}
+
+// Instante em que o relé pendente pode comutar: fim da janela de coalescência,
+// do intervalo mínimo desde a última comutação e, ao ligar, do escalonamento
+uint32_t RelayActuator::readyAt(int relay, bool turnOn) const
+{
+  uint32_t at = pendingSinceMs[relay] + mergeWindowMs;
+
+  if (switched & (1u << relay) && (int32_t)(lastSwitchMs[relay] + minSwitchMs - at) > 0)
+    at = lastSwitchMs[relay] + minSwitchMs;
+  if (turnOn && staggerMs > 0 && turnedOn && (int32_t)(lastTurnOnMs + staggerMs - at) > 0)
+    at = lastTurnOnMs + staggerMs;
+  return at;
+}
+
+uint32_t RelayActuator::update(uint32_t commanded, uint32_t nowMs)
+{
+  uint32_t differs = commanded ^ physical;
+
+  // Voltou ao estado físico antes de comutar: o comando foi absorvido
+  cancelled += __builtin_popcount(pending & ~differs);
+  pending &= differs;
+
+  for (uint32_t fresh = differs & ~pending; fresh != 0; fresh &= fresh - 1)
+    pendingSinceMs[__builtin_ctz(fresh)] = nowMs;
+  pending |= differs;
+
+  uint32_t next = IDLE;
+  uint32_t apply = 0;
+  for (uint32_t remaining = pending; remaining != 0; remaining &= remaining - 1)
+  {
+    int relay = __builtin_ctz(remaining);
+    uint32_t bit = 1u << relay;
+    bool turnOn = commanded & bit;
+
+    int32_t wait = (int32_t)(readyAt(relay, turnOn) - nowMs);
+    if (wait > 0)
+    {
+      if ((uint32_t)wait < next)
+        next = wait;
+      continue;
+    }
+
+    apply |= bit;
+    lastSwitchMs[relay] = nowMs;
+    switched |= bit;
+    if (turnOn)
+    {
+      lastTurnOnMs = nowMs; // Os próximos a ligar esperam o escalonamento
+      turnedOn = true;
+    }
+  }
+
+  physical ^= apply;
+  pending &= ~apply;
+  switches += __builtin_popcount(apply);
+  return next;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifndef ACTUATOR_MERGE_WINDOW_MS
+#define ACTUATOR_MERGE_WINDOW_MS 5 // Comandos do mesmo relé dentro da janela viram uma comutação
+#endif
+#ifndef ACTUATOR_MIN_SWITCH_MS
+#define ACTUATOR_MIN_SWITCH_MS 100 // Intervalo mínimo entre comutações de um mesmo relé
+#endif
+#ifndef ACTUATOR_STAGGER_MS
+#define ACTUATOR_STAGGER_MS 0 // > 0: liga no máximo um relé por intervalo (corrente de partida)
+#endif
+#ifndef ACTUATOR_RETRY_MS
+#define ACTUATOR_RETRY_MS 50 // Nova tentativa após uma escrita recusada pelas saídas (expansor sem ACK)
+#endif
+
+// Leva as saídas físicas ao estado comandado (RelayState) respeitando os
+// limites de comutação. A fila de comandos tem uma posição por relé: um
+// comando novo para um relé pendente substitui o anterior, e um pendente que
+// volta ao estado físico é descartado sem comutar. Usado por uma única tarefa;
+// os produtores só alteram o RelayState e a notificam.
+class RelayActuator
+{
+public:
+  static const uint32_t IDLE = UINT32_MAX;
+
+  void begin(uint32_t outputs, uint32_t mergeWindowMs, uint32_t minSwitchMs, uint32_t staggerMs);
+
+  // Recebe o estado comandado e calcula as saídas; retorna em quantos ms
+  // chamar de novo (IDLE: nada pendente, só na próxima mudança)
+  uint32_t update(uint32_t commanded, uint32_t nowMs);
+
+  uint32_t outputs() const { return physical; }
+  uint32_t pendingMask() const { return pending; }
+  uint32_t switchCount() const { return switches; } // Comutações físicas
+  uint32_t cancelCount() const { return cancelled; } // Pendentes desfeitos antes de comutar
+
+private:
+  uint32_t readyAt(int relay, bool turnOn) const;
+
+  uint32_t physical = 0;
+  uint32_t pending = 0;
+  uint32_t switched = 0; // Relés com lastSwitchMs válido
+  uint32_t mergeWindowMs = 0;
+  uint32_t minSwitchMs = 0;
+  uint32_t staggerMs = 0;
+  bool turnedOn = false; // lastTurnOnMs válido
+  uint32_t lastTurnOnMs = 0;
+  uint32_t pendingSinceMs[32];
+  uint32_t lastSwitchMs[32];
+  uint32_t switches = 0;
+  uint32_t cancelled = 0;
+};
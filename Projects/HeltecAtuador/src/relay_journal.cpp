@@ -0,0 +1,168 @@
+#include <relay_journal.h>
+
+static const uint8_t JOURNAL_MAGIC = 0xA5;
+
+static uint8_t crc8(const uint8_t *data, size_t len)
+{
+  uint8_t crc = 0;
+  while (len--)
+  {
+    crc ^= *data++;
+    for (int i = 0; i < 8; i++)
+      crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
+
+static uint8_t recordCrc(const uint8_t *record)
+{
+  uint8_t buffer[JOURNAL_RECORD_SIZE - 1];
+  buffer[0] = record[0];
+  memcpy(buffer + 1, record + 2, JOURNAL_RECORD_SIZE - 2);
+  return crc8(buffer, sizeof(buffer));
+}
+
+void encodeJournalRecord(const JournalRecord &record, uint8_t *out)
+{
+  out[0] = JOURNAL_MAGIC;
+  out[2] = record.seq;
+  out[3] = record.seq >> 8;
+  out[4] = record.mask;
+  out[5] = record.mask >> 8;
+  out[6] = record.mask >> 16;
+  out[7] = record.mask >> 24;
+  out[1] = recordCrc(out);
+}
+
+bool decodeJournalRecord(const uint8_t *in, JournalRecord &record)
+{
+  if (in[0] != JOURNAL_MAGIC || in[1] != recordCrc(in))
+    return false;
+
+  record.seq = in[2] | (in[3] << 8);
+  record.mask = in[4] | (in[5] << 8) | (in[6] << 16) | ((uint32_t)in[7] << 24);
+  return true;
+}
+
+RelayJournal::RelayJournal(fs::FS &fs, const char *path, const char *tempPath)
+    : fs(fs), path(path), tempPath(tempPath)
+{
+}
+
+bool RelayJournal::restore(uint32_t &mask)
+{
+  records = 0;
+
+  // Compactação interrompida: um temporário íntegro (exatamente um registro)
+  // é o estado mais novo e substitui o journal; um truncado é descartado
+  if (fs.exists(tempPath))
+  {
+    File temp = fs.open(tempPath, "r");
+    uint8_t buffer[JOURNAL_RECORD_SIZE];
+    JournalRecord record;
+    bool valid = temp && temp.size() == sizeof(buffer) && temp.read(buffer, sizeof(buffer)) == sizeof(buffer) &&
+                 decodeJournalRecord(buffer, record);
+    temp.close();
+
+    if (valid)
+      replaceWithTemp();
+    else
+      fs.remove(tempPath);
+  }
+
+  File file = fs.open(path, "r");
+  if (!file)
+    return false;
+
+  uint8_t buffer[JOURNAL_RECORD_SIZE];
+  JournalRecord record;
+  bool found = false;
+  size_t fileSize = file.size();
+
+  while (file.read(buffer, sizeof(buffer)) == sizeof(buffer))
+  {
+    if (!decodeJournalRecord(buffer, record))
+      break; // Cauda truncada: descarta o restante
+
+    records++;
+    seq = record.seq;
+    lastMask = record.mask;
+    found = true;
+  }
+  file.close();
+
+  // Regrava compactado se a cauda estava corrompida, para o próximo append ficar alinhado
+  if (found && records * JOURNAL_RECORD_SIZE != fileSize)
+    compact(lastMask);
+  else if (!found && fileSize > 0)
+    fs.remove(path); // Nenhum registro íntegro: o próximo append começa do zero
+
+  if (found)
+    mask = lastMask;
+  return found;
+}
+
+bool RelayJournal::record(uint32_t mask)
+{
+  if (records > 0 && mask == lastMask)
+    return true;
+
+  if (records >= JOURNAL_MAX_RECORDS)
+    return compact(mask);
+
+  return append(mask);
+}
+
+bool RelayJournal::append(uint32_t mask)
+{
+  File file = fs.open(path, "a");
+  if (!file)
+    return false;
+
+  uint8_t buffer[JOURNAL_RECORD_SIZE];
+  JournalRecord record = {(uint16_t)(seq + 1), mask};
+  encodeJournalRecord(record, buffer);
+  bool ok = file.write(buffer, sizeof(buffer)) == sizeof(buffer);
+  file.close();
+
+  if (ok)
+  {
+    records++;
+    seq = record.seq;
+    lastMask = mask;
+  }
+  return ok;
+}
+
+// No LittleFS o rename substitui o destino atomicamente
+bool RelayJournal::replaceWithTemp()
+{
+  if (fs.rename(tempPath, path))
+    return true;
+  fs.remove(path);
+  return fs.rename(tempPath, path);
+}
+
+bool RelayJournal::compact(uint32_t mask)
+{
+  File file = fs.open(tempPath, "w");
+  if (!file)
+    return false;
+
+  uint8_t buffer[JOURNAL_RECORD_SIZE];
+  JournalRecord record = {(uint16_t)(seq + 1), mask};
+  encodeJournalRecord(record, buffer);
+  bool ok = file.write(buffer, sizeof(buffer)) == sizeof(buffer);
+  file.close();
+
+  if (!ok)
+    return false;
+
+  if (!replaceWithTemp())
+    return false;
+
+  records = 1;
+  seq = record.seq;
+  lastMask = mask;
+  return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <FS.h>
+
+#ifndef JOURNAL_MAX_RECORDS
+#define JOURNAL_MAX_RECORDS 512 // 4 KB: compacta ao atingir um bloco do LittleFS
+#endif
+
+// Registro de 8 bytes: magic, crc8, seq, bitmask dos relés
+struct JournalRecord
+{
+  uint16_t seq;
+  uint32_t mask;
+};
+
+static const size_t JOURNAL_RECORD_SIZE = 8;
+
+void encodeJournalRecord(const JournalRecord &record, uint8_t *out);
+bool decodeJournalRecord(const uint8_t *in, JournalRecord &record);
+
+// Journal append-only do estado dos relés. Cada mudança vira um registro
+// de 8 bytes; um registro truncado por queda de energia falha no CRC e é
+// ignorado, então vale sempre o último registro íntegro. Ao encher, o
+// arquivo é compactado em um único registro via arquivo temporário + rename;
+// um temporário íntegro encontrado no boot conclui a compactação interrompida.
+class RelayJournal
+{
+public:
+  RelayJournal(fs::FS &fs, const char *path, const char *tempPath);
+
+  // Lê o journal e retorna o último estado gravado; falso se não houver
+  bool restore(uint32_t &mask);
+
+  // Grava o estado se diferente do último persistido
+  bool record(uint32_t mask);
+
+  size_t recordCount() const { return records; }
+
+private:
+  bool append(uint32_t mask);
+  bool compact(uint32_t mask);
+  bool replaceWithTemp();
+
+  fs::FS &fs;
+  const char *path;
+  const char *tempPath;
+  size_t records = 0;
+  uint16_t seq = 0;
+  uint32_t lastMask = 0;
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <stdint.h>
+#include <Arduino.h>
+#include <soc/gpio_struct.h>
+
+// Backends de saída dos relés, escolhidos em tempo de compilação pelo perfil
+// da placa (board_profile.h). Todos expõem COUNT, BLOCKING, begin(mask),
+// write(mask) e applied(), onde o bit i de mask é o relé i. begin() já escreve
+// mask como primeiro estado das saídas, antes de virarem saída: o estado
+// restaurado no boot não passa por um "tudo desligado". write() retorna false se alguma
+// saída ficou sem escrever (chip sem ACK no I2C); applied() informa o que de
+// fato chegou às saídas, e a próxima write() tenta de novo o que faltou.
+
+// Relés ligados direto em GPIOs (todos abaixo de 32): uma única escrita no
+// registrador de saída muda todos ao mesmo tempo
+template <uint8_t... Pins>
+class GpioRelayOutputs
+{
+public:
+  static const int COUNT = sizeof...(Pins);
+  static const bool BLOCKING = false; // Pode ser escrito dentro de seção crítica
+
+  GpioRelayOutputs() {}
+
+  // Mesma construção dos expansores; o barramento não é usado
+  template <class Bus>
+  explicit GpioRelayOutputs(Bus &) {}
+
+  void begin(uint32_t mask = 0)
+  {
+    write(mask);
+    for (int i = 0; i < COUNT; i++)
+      pinMode(pin(i), OUTPUT);
+  }
+
+  bool write(uint32_t mask)
+  {
+    uint32_t setMask = 0;
+    for (int i = 0; i < COUNT; i++)
+    {
+      if (mask & (1u << i))
+        setMask |= 1u << pin(i);
+    }
+
+    GPIO.out = (GPIO.out & ~pinsMask()) | setMask;
+    last = mask;
+    return true;
+  }
+
+  uint32_t applied() const { return last; }
+
+  static uint8_t pin(int i)
+  {
+    static const uint8_t pins[COUNT] = {Pins...};
+    return pins[i];
+  }
+
+private:
+  static uint32_t pinsMask()
+  {
+    uint32_t mask = 0;
+    for (int i = 0; i < COUNT; i++)
+      mask |= 1u << pin(i);
+    return mask;
+  }
+
+  static_assert(COUNT > 0 && COUNT <= 32, "De 1 a 32 relés");
+
+  uint32_t last = 0;
+};
+
+// MCP23017: 16 saídas por chip; OLATA e OLATB são escritos numa transação
+// só (endereço do registrador autoincrementa com IOCON.SEQOP = 0)
+// (endTransmission() == 0: o chip confirmou com ACK)
+struct Mcp23017Chip
+{
+  template <class Bus>
+  static bool begin(Bus &bus, uint8_t address, uint16_t value)
+  {
+    if (!writePort(bus, address, value)) // Latch antes de virar saída: sem pulso nos relés
+      return false;
+
+    bus.beginTransmission(address);
+    bus.write((uint8_t)0x00); // IODIRA
+    bus.write((uint8_t)0x00);
+    bus.write((uint8_t)0x00); // IODIRB
+    return bus.endTransmission() == 0;
+  }
+
+  template <class Bus>
+  static bool writePort(Bus &bus, uint8_t address, uint16_t value)
+  {
+    bus.beginTransmission(address);
+    bus.write((uint8_t)0x14); // OLATA
+    bus.write((uint8_t)value);
+    bus.write((uint8_t)(value >> 8));
+    return bus.endTransmission() == 0;
+  }
+};
+
+// PCF8575: 16 saídas quase-bidirecionais, escritas como dois bytes sem registrador
+struct Pcf8575Chip
+{
+  template <class Bus>
+  static bool begin(Bus &bus, uint8_t address, uint16_t value)
+  {
+    return writePort(bus, address, value);
+  }
+
+  template <class Bus>
+  static bool writePort(Bus &bus, uint8_t address, uint16_t value)
+  {
+    bus.beginTransmission(address);
+    bus.write((uint8_t)value);
+    bus.write((uint8_t)(value >> 8));
+    return bus.endTransmission() == 0;
+  }
+};
+
+// Expansores I2C de 16 saídas em endereços consecutivos. Cada write() envia
+// uma transação por chip cujas saídas mudaram, e nenhuma se nada mudou. Um
+// chip que não respondeu fica com o estado anterior em applied() e volta a ser
+// escrito (inicializado, se falhou no begin) na próxima write().
+// ActiveLow para módulos de relé acionados em nível baixo (comum com PCF8575).
+template <class Chip, class Bus, uint8_t FirstAddress, int Chips, bool ActiveLow = false>
+class ExpanderRelayOutputs
+{
+public:
+  static const int COUNT = Chips * 16;
+  static const bool BLOCKING = true; // Transação I2C: fora de seção crítica
+
+  explicit ExpanderRelayOutputs(Bus &bus) : bus(bus) {}
+
+  void begin(uint32_t mask = 0)
+  {
+    last = 0;
+    uninitialized = 0;
+    for (int chip = 0; chip < Chips; chip++)
+    {
+      uint32_t bits = 0xFFFFu << (chip * 16);
+      if (Chip::begin(bus, FirstAddress + chip, portValue(mask >> (chip * 16))))
+        last |= mask & bits;
+      else
+        uninitialized |= 1u << chip;
+    }
+  }
+
+  bool write(uint32_t mask)
+  {
+    uint32_t changed = mask ^ last;
+    bool written = true;
+    for (int chip = 0; chip < Chips; chip++)
+    {
+      uint32_t bits = 0xFFFFu << (chip * 16);
+      bool pending = uninitialized & (1u << chip);
+      if (!(changed & bits) && !pending)
+        continue;
+
+      uint16_t value = portValue(mask >> (chip * 16));
+      if (pending ? Chip::begin(bus, FirstAddress + chip, value) : Chip::writePort(bus, FirstAddress + chip, value))
+      {
+        last = (last & ~bits) | (mask & bits);
+        uninitialized &= ~(1u << chip);
+      }
+      else
+      {
+        written = false;
+      }
+    }
+    return written;
+  }
+
+  uint32_t applied() const { return last; }
+
+private:
+  static uint16_t portValue(uint32_t bits)
+  {
+    return ActiveLow ? ~bits : bits;
+  }
+
+  static_assert(Chips >= 1 && Chips <= 2, "De 16 a 32 relés");
+
+  Bus &bus;
+  uint32_t last = 0;
+  uint8_t uninitialized = 0; // Chips que falharam no begin()
+};
+
+template <class Bus, uint8_t FirstAddress, int Chips, bool ActiveLow = false>
+using Mcp23017RelayOutputs = ExpanderRelayOutputs<Mcp23017Chip, Bus, FirstAddress, Chips, ActiveLow>;
+
+template <class Bus, uint8_t FirstAddress, int Chips, bool ActiveLow = false>
+using Pcf8575RelayOutputs = ExpanderRelayOutputs<Pcf8575Chip, Bus, FirstAddress, Chips, ActiveLow>;
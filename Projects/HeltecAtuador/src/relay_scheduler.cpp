@@ -0,0 +1,313 @@
+#include <relay_scheduler.h>
+
+RelayScheduler::RelayScheduler()
+{
+  clear();
+}
+
+void RelayScheduler::clear()
+{
+  for (int level = 0; level < LEVELS; level++)
+    for (int slot = 0; slot < SLOTS; slot++)
+      slots[level][slot] = NONE;
+
+  for (int i = 0; i < CAPACITY; i++)
+  {
+    entries[i].used = false;
+    entries[i].next = i + 1 < CAPACITY ? i + 1 : NONE;
+  }
+  freeList = 0;
+  active = 0;
+}
+
+// Estende o millis() de 32 bits (que volta a zero em ~49 dias) para 64 bits
+uint64_t RelayScheduler::extend(uint32_t nowMs)
+{
+  nowMs64 += nowMs - lastNowMs;
+  lastNowMs = nowMs;
+  return nowMs64;
+}
+
+int RelayScheduler::add(const ScheduleJob &job, uint32_t nowMs)
+{
+  if (job.relays == 0 || freeList == NONE)
+    return -1;
+  if (job.action == RelayAction::Pulse && (job.pulseMs == 0 || (job.periodMs != 0 && job.pulseMs >= job.periodMs)))
+    return -1;
+  if (job.periodMs != 0 && job.periodMs < TICK_MS)
+    return -1;
+
+  uint64_t now = extend(nowMs);
+  if (active == 0)
+    currentTick = now / TICK_MS; // Wheel vazia: não há ticks atrasados a recuperar
+
+  int16_t id = freeList;
+  freeList = entries[id].next;
+
+  Entry &entry = entries[id];
+  entry.job = job;
+  entry.cycleStartMs = now + job.delayMs;
+  entry.dueMs = entry.cycleStartMs;
+  entry.pulseOn = false;
+  entry.used = true;
+  active++;
+
+  insert(id);
+  return id;
+}
+
+bool RelayScheduler::remove(int id)
+{
+  if (id < 0 || id >= CAPACITY || !entries[id].used)
+    return false;
+
+  unlink(id);
+  entries[id].used = false;
+  entries[id].next = freeList;
+  freeList = id;
+  active--;
+  return true;
+}
+
+bool RelayScheduler::retime(int id, uint32_t delayMs, uint32_t nowMs)
+{
+  if (id < 0 || id >= CAPACITY || !entries[id].used)
+    return false;
+
+  Entry &entry = entries[id];
+  uint64_t next = extend(nowMs) + delayMs;
+  if (entry.pulseOn)
+  {
+    entry.cycleStartMs = next - entry.job.periodMs; // fire() soma o período ao desligar
+    return true;
+  }
+
+  unlink(id);
+  entry.cycleStartMs = next;
+  entry.dueMs = next;
+  insert(id);
+  return true;
+}
+
+bool RelayScheduler::get(int id, ScheduleJob &job, uint32_t &remainingMs, uint32_t nowMs) const
+{
+  if (id < 0 || id >= CAPACITY || !entries[id].used)
+    return false;
+
+  uint64_t now = nowMs64 + (uint32_t)(nowMs - lastNowMs);
+  job = entries[id].job;
+  remainingMs = entries[id].dueMs > now ? (uint32_t)(entries[id].dueMs - now) : 0;
+  return true;
+}
+
+uint32_t RelayScheduler::nextStepMs(uint32_t nowMs) const
+{
+  if (active == 0)
+    return IDLE;
+
+  // Sem nada antes disso, acorda ao fim de uma volta do nível 1 para olhar de novo
+  uint32_t next = currentTick + SLOTS * SLOTS;
+
+  // Nível 0: um slot por tick, nos próximos SLOTS ticks
+  for (uint32_t tick = currentTick; tick != currentTick + SLOTS; tick++)
+  {
+    if (slots[0][tick & (SLOTS - 1)] != NONE)
+    {
+      next = tick;
+      break;
+    }
+  }
+
+  // Viradas do nível 0 antes disso: o step() desce um slot dos níveis de cima,
+  // e o prazo mais cedo entre os jobs dele conta (a descida em si não precisa
+  // de acordada, o step() a faz ao recuperar os ticks)
+  for (uint32_t tick = (currentTick + SLOTS - 1) & ~(uint32_t)(SLOTS - 1); (int32_t)(tick - next) < 0; tick += SLOTS)
+  {
+    int slot1 = (tick >> SLOT_BITS) & (SLOTS - 1);
+    next = earliestTick(slots[1][slot1], next);
+    if (slot1 != 0)
+      continue;
+
+    int slot2 = (tick >> (2 * SLOT_BITS)) & (SLOTS - 1);
+    next = earliestTick(slots[2][slot2], next);
+    if (slot2 == 0)
+      next = earliestTick(slots[3][(tick >> (3 * SLOT_BITS)) & (SLOTS - 1)], next);
+  }
+
+  // O tick "next" pode ser processado a partir de next * TICK_MS
+  uint64_t now = nowMs64 + (uint32_t)(nowMs - lastNowMs);
+  int32_t ticks = (int32_t)(next - (uint32_t)(now / TICK_MS));
+  return ticks > 0 ? ticks * TICK_MS - (uint32_t)(now % TICK_MS) : 0;
+}
+
+// Menor tick de vencimento entre os jobs da lista, ou "next" se nenhum vence antes
+uint32_t RelayScheduler::earliestTick(int16_t id, uint32_t next) const
+{
+  for (; id != NONE; id = entries[id].next)
+  {
+    uint32_t tick = tickOf(entries[id].dueMs);
+    if ((int32_t)(tick - next) < 0)
+      next = tick;
+  }
+  return next;
+}
+
+// Escolhe o nível pelo tempo restante, como nas timer wheels do kernel Linux
+void RelayScheduler::insert(int16_t id)
+{
+  Entry &entry = entries[id];
+  uint32_t expires = tickOf(entry.dueMs);
+  int32_t delta = (int32_t)(expires - currentTick);
+  int level;
+  int slot;
+
+  if (delta < 0)
+  {
+    level = 0; // Já venceu: executa no próximo tick
+    slot = currentTick & (SLOTS - 1);
+  }
+  else if (delta < (1 << SLOT_BITS))
+  {
+    level = 0;
+    slot = expires & (SLOTS - 1);
+  }
+  else if (delta < (1 << (2 * SLOT_BITS)))
+  {
+    level = 1;
+    slot = (expires >> SLOT_BITS) & (SLOTS - 1);
+  }
+  else if (delta < (1 << (3 * SLOT_BITS)))
+  {
+    level = 2;
+    slot = (expires >> (2 * SLOT_BITS)) & (SLOTS - 1);
+  }
+  else
+  {
+    // Além do alcance da wheel: fica no limite e é reinserido ao descer
+    if (delta >= (1 << (4 * SLOT_BITS)))
+      expires = currentTick + (1 << (4 * SLOT_BITS)) - 1;
+    level = 3;
+    slot = (expires >> (3 * SLOT_BITS)) & (SLOTS - 1);
+  }
+
+  int16_t &head = slots[level][slot];
+  entry.bucket = level * SLOTS + slot;
+  entry.prev = NONE;
+  entry.next = head;
+  if (head != NONE)
+    entries[head].prev = id;
+  head = id;
+}
+
+void RelayScheduler::unlink(int16_t id)
+{
+  Entry &entry = entries[id];
+  if (entry.bucket == NONE)
+    return;
+
+  if (entry.prev != NONE)
+    entries[entry.prev].next = entry.next;
+  else
+    slots[entry.bucket / SLOTS][entry.bucket % SLOTS] = entry.next;
+
+  if (entry.next != NONE)
+    entries[entry.next].prev = entry.prev;
+
+  entry.bucket = NONE;
+}
+
+// Redistribui um slot de nível superior nos níveis abaixo; retorna o slot
+int RelayScheduler::cascade(int level, int slot)
+{
+  int16_t id = slots[level][slot];
+  slots[level][slot] = NONE;
+
+  while (id != NONE)
+  {
+    int16_t next = entries[id].next;
+    entries[id].bucket = NONE;
+    insert(id);
+    id = next;
+  }
+
+  return slot;
+}
+
+bool RelayScheduler::step(uint32_t nowMs, ScheduledAction *due, size_t &count)
+{
+  count = 0;
+  uint32_t nowTick = extend(nowMs) / TICK_MS;
+
+  if (active == 0)
+  {
+    currentTick = nowTick + 1;
+    return false;
+  }
+
+  if ((int32_t)(nowTick - currentTick) < 0)
+    return false;
+
+  int index = currentTick & (SLOTS - 1);
+  if (index == 0 &&
+      cascade(1, (currentTick >> SLOT_BITS) & (SLOTS - 1)) == 0 &&
+      cascade(2, (currentTick >> (2 * SLOT_BITS)) & (SLOTS - 1)) == 0)
+    cascade(3, (currentTick >> (3 * SLOT_BITS)) & (SLOTS - 1));
+
+  // Desanexa a lista antes de executar: fire() pode reinserir jobs
+  int16_t id = slots[0][index];
+  slots[0][index] = NONE;
+  currentTick++;
+
+  while (id != NONE)
+  {
+    int16_t next = entries[id].next;
+    entries[id].bucket = NONE;
+
+    if ((int32_t)(tickOf(entries[id].dueMs) - (currentTick - 1)) > 0)
+      insert(id); // Prazo além do alcance da wheel: ainda não venceu
+    else
+      fire(id, due, count);
+
+    id = next;
+  }
+
+  return true;
+}
+
+void RelayScheduler::fire(int16_t id, ScheduledAction *due, size_t &count)
+{
+  Entry &entry = entries[id];
+  const ScheduleJob &job = entry.job;
+  ScheduledAction &action = due[count++];
+  action.relays = job.relays;
+  action.id = id;
+  action.clockMinute = job.action != RelayAction::Pulse || !entry.pulseOn ? job.clockMinute : -1;
+
+  if (job.action == RelayAction::Pulse)
+  {
+    entry.pulseOn = !entry.pulseOn;
+    action.action = entry.pulseOn ? RelayAction::On : RelayAction::Off;
+
+    if (entry.pulseOn)
+    {
+      entry.dueMs = entry.cycleStartMs + job.pulseMs;
+      insert(id);
+      return;
+    }
+  }
+  else
+  {
+    action.action = job.action;
+  }
+
+  if (job.periodMs == 0)
+  {
+    remove(id);
+    return;
+  }
+
+  // Próximo ciclo a partir do prazo anterior, não do instante atual: sem deriva
+  entry.cycleStartMs += job.periodMs;
+  entry.dueMs = entry.cycleStartMs;
+  insert(id);
+}
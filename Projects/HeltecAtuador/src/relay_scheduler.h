@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SCHEDULER_MAX_JOBS
+#define SCHEDULER_MAX_JOBS 32
+#endif
+
+enum class RelayAction : uint8_t
+{
+  On,
+  Off,
+  Toggle,
+  Pulse // Liga, e desliga após pulseMs
+};
+
+struct ScheduleJob
+{
+  RelayAction action;
+  uint32_t relays;     // Bitmask dos relés afetados
+  uint32_t delayMs;    // Até a primeira execução
+  uint32_t periodMs;   // Intervalo entre execuções; 0 = uma vez só
+  uint32_t pulseMs;    // Duração do pulso (menor que periodMs, se recorrente)
+  int16_t clockMinute; // Horário local (minutos do dia) de onde veio o delay; -1 = relativo
+};
+
+// Ação vencida, a ser aplicada pelo chamador fora da seção crítica
+struct ScheduledAction
+{
+  RelayAction action; // On, Off ou Toggle
+  uint32_t relays;
+  int id;
+  int16_t clockMinute; // Início de ciclo de um job com horário (para retime); -1 nos demais
+};
+
+// Agendador de ações dos relés em uma timing wheel hierárquica (4 níveis de
+// 64 slots, tick de 10 ms, ~46 h no último nível; prazos maiores são
+// reinseridos). O custo por tick é O(1) independente do número de jobs:
+// cada job só é tocado ao vencer ou ao descer de nível.
+// Os prazos são absolutos (ms desde o início, em 64 bits), então jobs
+// recorrentes não acumulam deriva mesmo com ticks processados atrasados.
+// Não depende do hardware: o tempo vem sempre do chamador.
+class RelayScheduler
+{
+public:
+  static const uint32_t TICK_MS = 10;
+  static const int CAPACITY = SCHEDULER_MAX_JOBS;
+  static const uint32_t IDLE = UINT32_MAX;
+
+  RelayScheduler();
+
+  // Agenda um job e retorna seu id, ou -1 se inválido ou sem espaço
+  int add(const ScheduleJob &job, uint32_t nowMs);
+  bool remove(int id);
+  void clear();
+
+  // Move o próximo ciclo do job para delayMs a partir de agora; um pulso em
+  // andamento ainda desliga no prazo dele
+  bool retime(int id, uint32_t delayMs, uint32_t nowMs);
+
+  // Dados do job e ms até a próxima execução
+  bool get(int id, ScheduleJob &job, uint32_t &remainingMs, uint32_t nowMs) const;
+
+  // Processa o próximo tick vencido até nowMs, gravando em "due" (com espaço
+  // para CAPACITY ações) o que deve ser executado. Retorna false quando está
+  // em dia; o chamador repete enquanto retornar true.
+  bool step(uint32_t nowMs, ScheduledAction *due, size_t &count);
+
+  // Ms até o próximo tick com execução, limitado a uma volta do nível 1
+  // (~41 s); IDLE sem jobs. Olha os slots do nível 0 e os que descem nas
+  // viradas dentro do prazo. O chamador dorme até lá: os ticks vazios e as
+  // descidas são recuperados no próximo step().
+  uint32_t nextStepMs(uint32_t nowMs) const;
+
+  int activeCount() const { return active; }
+
+private:
+  static const int LEVELS = 4;
+  static const int SLOT_BITS = 6;
+  static const int SLOTS = 1 << SLOT_BITS;
+  static const int16_t NONE = -1;
+
+  struct Entry
+  {
+    ScheduleJob job;
+    uint64_t cycleStartMs; // Início do ciclo atual (execução "On" do pulso)
+    uint64_t dueMs;
+    int16_t next;
+    int16_t prev;
+    int16_t bucket; // level * SLOTS + slot, ou NONE se fora da wheel
+    bool used;
+    bool pulseOn;
+  };
+
+  uint64_t extend(uint32_t nowMs);
+  static uint32_t tickOf(uint64_t ms) { return (uint32_t)((ms + TICK_MS - 1) / TICK_MS); }
+  void insert(int16_t id);
+  void unlink(int16_t id);
+  uint32_t earliestTick(int16_t id, uint32_t next) const;
+  int cascade(int level, int slot);
+  void fire(int16_t id, ScheduledAction *due, size_t &count);
+
+  Entry entries[CAPACITY];
+  int16_t slots[LEVELS][SLOTS];
+  int16_t freeList;
+  int active = 0;
+  uint32_t currentTick = 0; // Próximo tick a processar
+  uint32_t lastNowMs = 0;
+  uint64_t nowMs64 = 0;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// Estado consistente dos relés: bitmask + versão da última mudança
+struct RelaySnapshot
+{
+  uint32_t mask;
+  uint32_t version;
+};
+
+// Estado dos relés em uma única palavra atômica (versão << 32 | bitmask).
+// Leitores obtêm um snapshot consistente com um load; escritores usam CAS e
+// só incrementam a versão quando algum relé realmente muda.
+// No Xtensa o acesso de 64 bits é emulado pela libatomic com uma seção
+// crítica curta, mas continua sendo uma única operação indivisível.
+class RelayState
+{
+public:
+  RelaySnapshot snapshot() const
+  {
+    return unpack(word.load(std::memory_order_acquire));
+  }
+
+  // Aplica "target" nos bits de "touch" e retorna o snapshot resultante
+  RelaySnapshot apply(uint32_t target, uint32_t touch)
+  {
+    uint64_t current = word.load(std::memory_order_relaxed);
+    uint64_t next;
+
+    do
+    {
+      RelaySnapshot snap = unpack(current);
+      uint32_t mask = (snap.mask & ~touch) | (target & touch);
+      if (mask == snap.mask)
+        return snap;
+
+      next = pack(mask, snap.version + 1);
+    } while (!word.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    return unpack(next);
+  }
+
+private:
+  static uint64_t pack(uint32_t mask, uint32_t version)
+  {
+    return ((uint64_t)version << 32) | mask;
+  }
+
+  static RelaySnapshot unpack(uint64_t value)
+  {
+    RelaySnapshot snap = {(uint32_t)value, (uint32_t)(value >> 32)};
+    return snap;
+  }
+
+  std::atomic<uint64_t> word{0};
+};
+
+// Bitmask das últimas SIZE versões, para respostas delta (/status?since=).
+// Cada versão ocupa o slot version % SIZE; escritores concorrentes gravam
+// versões distintas, e uma versão sobrescrita simplesmente deixa de ser achada.
+// Zerado corresponde ao estado inicial (versão 0, relés desligados).
+class RelayHistory
+{
+public:
+  static const uint32_t SIZE = 64;
+
+  void record(const RelaySnapshot &snap)
+  {
+    slots[snap.version % SIZE].store(((uint64_t)snap.version << 32) | snap.mask, std::memory_order_release);
+  }
+
+  // Bitmask na versão pedida; false se ela já saiu do histórico ou ainda não existe
+  bool find(uint32_t version, uint32_t &mask) const
+  {
+    uint64_t value = slots[version % SIZE].load(std::memory_order_acquire);
+    if ((uint32_t)(value >> 32) != version)
+      return false;
+
+    mask = (uint32_t)value;
+    return true;
+  }
+
+private:
+  std::atomic<uint64_t> slots[SIZE] = {};
+};
@@ -0,0 +1,100 @@
+#include <schedule_store.h>
+
+// Cabeçalho: magic, versão, quantidade (u16 LE); seguido dos registros
+static const uint8_t SCHEDULE_MAGIC = 0x5C;
+static const uint8_t SCHEDULE_VERSION = 1;
+static const size_t SCHEDULE_HEADER_SIZE = 4;
+
+static void putU32(uint8_t *out, uint32_t value)
+{
+  out[0] = value;
+  out[1] = value >> 8;
+  out[2] = value >> 16;
+  out[3] = value >> 24;
+}
+
+static uint32_t getU32(const uint8_t *in)
+{
+  return in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+void encodeScheduleJob(const ScheduleJob &job, uint8_t *out)
+{
+  out[0] = (uint8_t)job.action;
+  out[1] = 0;
+  out[2] = (uint16_t)job.clockMinute;
+  out[3] = (uint16_t)job.clockMinute >> 8;
+  putU32(out + 4, job.relays);
+  putU32(out + 8, job.delayMs);
+  putU32(out + 12, job.periodMs);
+  putU32(out + 16, job.pulseMs);
+}
+
+bool decodeScheduleJob(const uint8_t *in, ScheduleJob &job)
+{
+  if (in[0] > (uint8_t)RelayAction::Pulse)
+    return false;
+
+  job.action = (RelayAction)in[0];
+  job.clockMinute = (int16_t)(in[2] | (in[3] << 8));
+  job.relays = getU32(in + 4);
+  job.delayMs = getU32(in + 8);
+  job.periodMs = getU32(in + 12);
+  job.pulseMs = getU32(in + 16);
+  return true;
+}
+
+bool saveScheduleJobs(fs::FS &fs, const char *path, const char *tempPath, const ScheduleJob *jobs, size_t count)
+{
+  File file = fs.open(tempPath, "w");
+  if (!file)
+    return false;
+
+  uint8_t header[SCHEDULE_HEADER_SIZE] = {SCHEDULE_MAGIC, SCHEDULE_VERSION, (uint8_t)count, (uint8_t)(count >> 8)};
+  bool ok = file.write(header, sizeof(header)) == sizeof(header);
+
+  uint8_t buffer[SCHEDULE_RECORD_SIZE];
+  for (size_t i = 0; ok && i < count; i++)
+  {
+    encodeScheduleJob(jobs[i], buffer);
+    ok = file.write(buffer, sizeof(buffer)) == sizeof(buffer);
+  }
+  file.close();
+
+  if (!ok)
+  {
+    fs.remove(tempPath);
+    return false;
+  }
+
+  if (!fs.rename(tempPath, path))
+  {
+    fs.remove(path);
+    return fs.rename(tempPath, path);
+  }
+  return true;
+}
+
+size_t loadScheduleJobs(fs::FS &fs, const char *path, ScheduleJob *jobs, size_t max)
+{
+  File file = fs.open(path, "r");
+  if (!file)
+    return 0;
+
+  uint8_t header[SCHEDULE_HEADER_SIZE];
+  size_t count = 0;
+  if (file.read(header, sizeof(header)) == sizeof(header) && header[0] == SCHEDULE_MAGIC &&
+      header[1] == SCHEDULE_VERSION && file.size() == sizeof(header) + (header[2] | (header[3] << 8)) * SCHEDULE_RECORD_SIZE)
+  {
+    size_t stored = header[2] | (header[3] << 8);
+    uint8_t buffer[SCHEDULE_RECORD_SIZE];
+
+    while (count < stored && count < max && file.read(buffer, sizeof(buffer)) == sizeof(buffer))
+    {
+      if (decodeScheduleJob(buffer, jobs[count]))
+        count++;
+    }
+  }
+  file.close();
+  return count;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <FS.h>
+#include <relay_scheduler.h>
+
+static const size_t SCHEDULE_RECORD_SIZE = 20;
+
+void encodeScheduleJob(const ScheduleJob &job, uint8_t *out);
+bool decodeScheduleJob(const uint8_t *in, ScheduleJob &job);
+
+// Persiste a lista de jobs recorrentes inteira via arquivo temporário + rename
+bool saveScheduleJobs(fs::FS &fs, const char *path, const char *tempPath, const ScheduleJob *jobs, size_t count);
+
+// Lê até "max" jobs; retorna quantos foram lidos (0 se ausente ou corrompido)
+size_t loadScheduleJobs(fs::FS &fs, const char *path, ScheduleJob *jobs, size_t max);
@@ -0,0 +1,183 @@
+#include <udp_control.h>
+
+static uint32_t readU32(const uint8_t *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void writeU32(uint8_t *p, uint32_t value)
+{
+  p[0] = value;
+  p[1] = value >> 8;
+  p[2] = value >> 16;
+  p[3] = value >> 24;
+}
+
+void UdpControl::begin(uint8_t relayCount, const char *key, Applier apply, OutputsReader readOutputs)
+{
+  this->relayCount = relayCount;
+  this->apply = apply;
+  this->readOutputs = readOutputs;
+  allRelays = relayCount >= 32 ? UINT32_MAX : (1u << relayCount) - 1;
+
+  // HMAC: chaves maiores que o bloco são substituídas pelo hash
+  uint8_t block[64] = {};
+  size_t keyLength = strlen(key);
+  keyed = keyLength > 0;
+  if (keyLength > sizeof(block))
+  {
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    mbedtls_sha256_update(&sha, (const uint8_t *)key, keyLength);
+    mbedtls_sha256_finish(&sha, block);
+    mbedtls_sha256_free(&sha);
+  }
+  else
+  {
+    memcpy(block, key, keyLength);
+  }
+
+  uint8_t innerPad[64];
+  uint8_t outerPad[64];
+  for (size_t i = 0; i < sizeof(block); i++)
+  {
+    innerPad[i] = block[i] ^ 0x36;
+    outerPad[i] = block[i] ^ 0x5c;
+  }
+
+  mbedtls_sha256_init(&innerState);
+  mbedtls_sha256_starts(&innerState, 0);
+  mbedtls_sha256_update(&innerState, innerPad, sizeof(innerPad));
+  mbedtls_sha256_init(&outerState);
+  mbedtls_sha256_starts(&outerState, 0);
+  mbedtls_sha256_update(&outerState, outerPad, sizeof(outerPad));
+}
+
+void UdpControl::computeTag(uint32_t challenge, const uint8_t *message, size_t length, uint8_t tag[32])
+{
+  uint8_t prefix[4];
+  writeU32(prefix, challenge);
+
+  mbedtls_sha256_context sha;
+  mbedtls_sha256_init(&sha);
+  mbedtls_sha256_clone(&sha, &innerState);
+  mbedtls_sha256_update(&sha, prefix, sizeof(prefix));
+  mbedtls_sha256_update(&sha, message, length);
+  mbedtls_sha256_finish(&sha, tag);
+
+  mbedtls_sha256_clone(&sha, &outerState);
+  mbedtls_sha256_update(&sha, tag, 32);
+  mbedtls_sha256_finish(&sha, tag);
+  mbedtls_sha256_free(&sha);
+}
+
+// Sessão existente ou, se nova, a entrada usada há mais tempo
+UdpControl::Session *UdpControl::findSession(uint32_t id)
+{
+  Session *oldest = &sessions[0];
+  for (Session &session : sessions)
+  {
+    if (session.lastUse != 0 && session.id == id)
+      return &session;
+    if (session.lastUse < oldest->lastUse)
+      oldest = &session;
+  }
+  return oldest;
+}
+
+void UdpControl::writeAck(uint8_t *reply, size_t &replyLength, UdpStatus status, uint32_t challenge,
+                          uint32_t sessionId, uint32_t seq, uint32_t mask, uint32_t version, uint32_t outputs)
+{
+  reply[0] = MAGIC;
+  reply[1] = TYPE_ACK;
+  reply[2] = (uint8_t)status;
+  reply[3] = relayCount;
+  writeU32(reply + 4, sessionId);
+  writeU32(reply + 8, seq);
+  writeU32(reply + 12, mask);
+  writeU32(reply + 16, version);
+  writeU32(reply + 20, outputs);
+  replyLength = ACK_SIZE;
+
+  if (keyed)
+  {
+    uint8_t tag[32];
+    computeTag(challenge, reply, ACK_SIZE, tag);
+    memcpy(reply + ACK_SIZE, tag, TAG_SIZE);
+    replyLength = MAX_ACK_SIZE;
+  }
+}
+
+UdpStatus UdpControl::handle(const uint8_t *packet, size_t length, uint8_t *reply, size_t &replyLength)
+{
+  replyLength = 0;
+
+  if (length != MESSAGE_SIZE && length != MAX_PACKET_SIZE)
+    return UdpStatus::Malformed;
+  if (packet[0] != MAGIC || packet[1] != TYPE_COMMAND)
+    return UdpStatus::Malformed;
+  if (keyed && length != MAX_PACKET_SIZE)
+    return UdpStatus::Unauthorized;
+
+  uint32_t sessionId = readU32(packet + 4);
+  uint32_t seq = readU32(packet + 8);
+  uint32_t set = readU32(packet + 12);
+  uint32_t clear = readU32(packet + 16);
+
+  Session *session = findSession(sessionId);
+  if (session->lastUse == 0 || session->id != sessionId)
+  {
+    // Sessão entrando na tabela: desafio novo invalida comandos capturados antes
+    session->id = sessionId;
+    session->started = false;
+    session->challenge = esp_random();
+    session->lastUse = ++useCounter;
+
+    if (keyed)
+    {
+      writeAck(reply, replyLength, UdpStatus::Challenge, session->challenge, sessionId, seq, session->challenge, 0, 0);
+      return UdpStatus::Challenge;
+    }
+  }
+  else if (keyed)
+  {
+    // Comparação em tempo constante
+    uint8_t tag[32];
+    computeTag(session->challenge, packet, MESSAGE_SIZE, tag);
+    uint8_t difference = 0;
+    for (size_t i = 0; i < TAG_SIZE; i++)
+      difference |= tag[i] ^ packet[MESSAGE_SIZE + i];
+    if (difference != 0)
+    {
+      writeAck(reply, replyLength, UdpStatus::Challenge, session->challenge, sessionId, seq, session->challenge, 0, 0);
+      return UdpStatus::Challenge;
+    }
+  }
+
+  UdpStatus status;
+  RelaySnapshot snap;
+  int32_t age = (int32_t)(seq - session->seq); // Aceita a volta do contador
+
+  if ((set | clear) & ~allRelays || set & clear)
+    status = UdpStatus::Invalid;
+  else if (session->started && age == 0)
+    status = UdpStatus::Duplicate;
+  else if (session->started && age < 0)
+    status = UdpStatus::Stale;
+  else
+  {
+    status = UdpStatus::Applied;
+    session->seq = seq;
+    session->started = true;
+  }
+  session->lastUse = ++useCounter;
+
+  snap = apply(status == UdpStatus::Applied ? set : 0, status == UdpStatus::Applied ? set | clear : 0);
+
+  if (packet[2] & FLAG_NO_ACK)
+    return status;
+
+  writeAck(reply, replyLength, status, session->challenge, sessionId, seq, snap.mask, snap.version, readOutputs());
+  return status;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Arduino.h>
+#include <mbedtls/sha256.h>
+#include <relay_state.h>
+
+#ifndef UDP_CONTROL_PORT
+#define UDP_CONTROL_PORT 4210
+#endif
+#ifndef UDP_CONTROL_KEY
+#define UDP_CONTROL_KEY "" // Chave do HMAC; vazia aceita comandos sem autenticação
+#endif
+
+// Resultado de um datagrama; também vai no campo "status" do ack
+enum class UdpStatus : uint8_t
+{
+  Applied = 0,     // Aplicado (ou consulta/sem mudança)
+  Duplicate = 1,   // Mesmo seq do último comando da sessão: não reaplicado
+  Stale = 2,       // seq anterior ao último da sessão (fora de ordem): descartado
+  Invalid = 3,      // Relé inexistente ou o mesmo bit em set e clear
+  Malformed = 4,    // Sem resposta
+  Unauthorized = 5, // HMAC ausente; sem resposta
+  Challenge = 6     // Sessão sem desafio vigente ou HMAC incorreto: não aplicado, o ack traz o desafio
+};
+
+// Protocolo binário de controle dos relés por UDP (little-endian).
+//
+// Comando, 20 bytes (+ 8 de HMAC):
+//   0  u8  magic 'R'          1  u8  tipo 1
+//   2  u8  flags (bit 0: sem ack)        3  u8  reservado
+//   4  u32 sessão (aleatória por cliente) 8  u32 seq (crescente na sessão)
+//   12 u32 set (relés a ligar)            16 u32 clear (relés a desligar)
+// set = clear = 0 é uma consulta de estado.
+//
+// Ack, 24 bytes (+ 8 de HMAC):
+//   0  u8  'R'   1 u8 tipo 2   2 u8 status (UdpStatus)   3 u8 número de relés
+//   4  u32 sessão   8 u32 seq   12 u32 mask   16 u32 versão   20 u32 saídas
+// mask é o estado comandado; saídas é o que está aplicado nos relés, que
+// alcança mask pelo atuador (coalescência, intervalo mínimo e novas tentativas
+// de escrita, ver relay_actuator.h). Uma consulta repetida mostra quando igualam.
+//
+// O seq por sessão torna retransmissões idempotentes e descarta comandos
+// atrasados; a tabela guarda as últimas SESSIONS sessões e é zerada no boot.
+//
+// Com chave, o HMAC-SHA256 (truncado em 8) de desafio (u32) + mensagem é
+// obrigatório nos comandos e vai também no ack. O desafio é sorteado pelo
+// dispositivo para cada sessão que entra na tabela: o primeiro comando de uma
+// sessão nova, descartada da tabela ou de antes de um reboot recebe o ack
+// Challenge (mask = desafio, versão = saídas = 0, HMAC com esse desafio) e o cliente
+// reenvia. Comandos capturados antes não são reaceitos, mesmo com a tabela
+// zerada. HMAC incorreto numa sessão conhecida também recebe o desafio vigente.
+class UdpControl
+{
+public:
+  static const size_t MESSAGE_SIZE = 20;
+  static const size_t TAG_SIZE = 8;
+  static const size_t MAX_PACKET_SIZE = MESSAGE_SIZE + TAG_SIZE;
+  static const size_t ACK_SIZE = 24;
+  static const size_t MAX_ACK_SIZE = ACK_SIZE + TAG_SIZE;
+  static const size_t SESSIONS = 8;
+  static const uint8_t MAGIC = 'R';
+  static const uint8_t TYPE_COMMAND = 1;
+  static const uint8_t TYPE_ACK = 2;
+  static const uint8_t FLAG_NO_ACK = 1 << 0;
+
+  // Aplica "target" nos relés de "touch" (o mesmo caminho dos handlers HTTP)
+  typedef RelaySnapshot (*Applier)(uint32_t target, uint32_t touch);
+  // Máscara aplicada nas saídas físicas
+  typedef uint32_t (*OutputsReader)();
+
+  void begin(uint8_t relayCount, const char *key, Applier apply, OutputsReader readOutputs);
+
+  // Processa um datagrama e monta o ack em "reply" (MAX_ACK_SIZE bytes; replyLength = 0: não responder).
+  // Chamado só pela tarefa do AsyncUDP; a tabela de sessões não tem trava.
+  UdpStatus handle(const uint8_t *packet, size_t length, uint8_t *reply, size_t &replyLength);
+
+  bool authenticated() const { return keyed; }
+
+private:
+  struct Session
+  {
+    uint32_t id;
+    uint32_t seq;
+    uint32_t lastUse;
+    uint32_t challenge;
+    bool started; // seq válido: já aplicou um comando
+  };
+
+  Session *findSession(uint32_t id);
+  void computeTag(uint32_t challenge, const uint8_t *message, size_t length, uint8_t tag[32]);
+  void writeAck(uint8_t *reply, size_t &replyLength, UdpStatus status, uint32_t challenge, uint32_t sessionId,
+                uint32_t seq, uint32_t mask, uint32_t version, uint32_t outputs);
+
+  Applier apply = NULL;
+  OutputsReader readOutputs = NULL;
+  uint32_t allRelays = 0;
+  uint8_t relayCount = 0;
+  bool keyed = false;
+  // Hash já com o bloco da chave (XOR 0x36 / 0x5c): cada tag custa 2 blocos em vez de 4
+  mbedtls_sha256_context innerState;
+  mbedtls_sha256_context outerState;
+  Session sessions[SESSIONS] = {};
+  uint32_t useCounter = 0;
+};
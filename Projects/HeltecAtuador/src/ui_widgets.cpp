@@ -0,0 +1,95 @@
+#include <ui_widgets.h>
+
+bool Widget::render(Adafruit_GFX &gfx)
+{
+  // update() sempre roda para o widget acompanhar o valor mesmo quando já está sujo
+  if (!update() && !dirty)
+    return false;
+
+  gfx.fillRect(x, y, w, h, 0);
+  draw(gfx);
+  dirty = false;
+  return true;
+}
+
+Label::Label(int16_t x, int16_t y, const char *text)
+    : Widget(x, y, strlen(text) * 6, 8), text(text)
+{
+}
+
+void Label::draw(Adafruit_GFX &gfx)
+{
+  gfx.setCursor(x, y);
+  gfx.print(text);
+}
+
+void Rule::draw(Adafruit_GFX &gfx)
+{
+  gfx.drawFastHLine(x, y, w, 1);
+}
+
+TextField::TextField(int16_t x, int16_t y, int16_t w, TextSource source, int arg, ValueSource version)
+    : Widget(x, y, w, 8), source(source), arg(arg), version(version)
+{
+}
+
+bool TextField::update()
+{
+  if (version != NULL)
+  {
+    uint32_t current = version();
+    if (formatted && current == seenVersion)
+      return false;
+    seenVersion = current;
+  }
+
+  char next[TEXT_SIZE];
+  next[0] = '\0';
+  source(next, sizeof(next), arg);
+  formatted = true;
+
+  if (strcmp(next, text) == 0)
+    return false;
+
+  memcpy(text, next, sizeof(text));
+  return true;
+}
+
+void TextField::draw(Adafruit_GFX &gfx)
+{
+  gfx.setCursor(x, y);
+  gfx.print(text);
+}
+
+bool ValueWidget::update()
+{
+  uint32_t next = value();
+  if (read && next == current)
+    return false;
+
+  current = next;
+  read = true;
+  return true;
+}
+
+void ValueWidget::draw(Adafruit_GFX &gfx)
+{
+  drawer(gfx, current);
+}
+
+void Screen::invalidate()
+{
+  for (size_t i = 0; i < count; i++)
+    widgets[i]->invalidate();
+}
+
+size_t Screen::render(Adafruit_GFX &gfx)
+{
+  size_t drawn = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    if (widgets[i]->render(gfx))
+      drawn++;
+  }
+  return drawn;
+}
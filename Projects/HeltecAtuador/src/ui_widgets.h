@@ -0,0 +1,117 @@
+#pragma once
+
+#include <Adafruit_GFX.h>
+
+// Escreve o texto atual de um campo em buffer; arg distingue campos que
+// compartilham a mesma fonte (ex.: linhas do log)
+typedef void (*TextSource)(char *buffer, size_t size, int arg);
+
+// Valor do dado vinculado a um widget (versão, bitmask...); muda quando o dado muda
+typedef uint32_t (*ValueSource)();
+
+// Desenha um widget a partir do valor vinculado
+typedef void (*ValueDrawer)(Adafruit_GFX &gfx, uint32_t value);
+
+// Elemento de tela em modo retido: o framebuffer guarda o último desenho e o
+// widget só é apagado e redesenhado quando invalidado ou quando o valor muda.
+class Widget
+{
+public:
+  Widget(int16_t x, int16_t y, int16_t w, int16_t h) : x(x), y(y), w(w), h(h) {}
+
+  // Redesenha se necessário; retorna true se algo foi desenhado
+  bool render(Adafruit_GFX &gfx);
+
+  // Força o redesenho no próximo render (ex.: troca de tela)
+  void invalidate() { dirty = true; }
+
+protected:
+  // Lê o valor vinculado; true se mudou desde o último desenho
+  virtual bool update() { return false; }
+  virtual void draw(Adafruit_GFX &gfx) = 0;
+
+  int16_t x, y, w, h;
+  bool dirty = true;
+};
+
+// Texto fixo (fonte padrão 6x8)
+class Label : public Widget
+{
+public:
+  Label(int16_t x, int16_t y, const char *text);
+
+protected:
+  void draw(Adafruit_GFX &gfx) override;
+
+private:
+  const char *text;
+};
+
+// Linha horizontal fixa
+class Rule : public Widget
+{
+public:
+  Rule(int16_t x, int16_t y, int16_t w) : Widget(x, y, w, 1) {}
+
+protected:
+  void draw(Adafruit_GFX &gfx) override;
+};
+
+// Campo de texto de uma linha. Com "version", a fonte só é consultada
+// quando a versão muda; sem ela, a cada render. Só rasteriza se o texto mudou.
+class TextField : public Widget
+{
+public:
+  static const size_t TEXT_SIZE = 22; // 21 colunas de 6 px + '\0'
+
+  TextField(int16_t x, int16_t y, int16_t w, TextSource source, int arg = 0, ValueSource version = NULL);
+
+protected:
+  bool update() override;
+  void draw(Adafruit_GFX &gfx) override;
+
+private:
+  TextSource source;
+  int arg;
+  ValueSource version;
+  uint32_t seenVersion = 0;
+  bool formatted = false;
+  char text[TEXT_SIZE] = "";
+};
+
+// Área desenhada por função, refeita quando o valor vinculado muda
+class ValueWidget : public Widget
+{
+public:
+  ValueWidget(int16_t x, int16_t y, int16_t w, int16_t h, ValueSource value, ValueDrawer drawer)
+      : Widget(x, y, w, h), value(value), drawer(drawer) {}
+
+protected:
+  bool update() override;
+  void draw(Adafruit_GFX &gfx) override;
+
+private:
+  ValueSource value;
+  ValueDrawer drawer;
+  uint32_t current = 0;
+  bool read = false;
+};
+
+// Conjunto de widgets que formam uma tela
+class Screen
+{
+public:
+  Screen(Widget *const *widgets, size_t count) : widgets(widgets), count(count) {}
+
+  template <size_t N>
+  Screen(Widget *const (&widgets)[N]) : widgets(widgets), count(N) {}
+
+  void invalidate();
+
+  // Redesenha os widgets alterados e retorna quantos foram desenhados
+  size_t render(Adafruit_GFX &gfx);
+
+private:
+  Widget *const *widgets;
+  size_t count;
+};
@@ -0,0 +1,123 @@
+// Máquina de estados do botão (src/button_input.h) com bordas sintéticas. Uso: pio test -e native
+
+#include <button_input.h>
+#include <unity.h>
+
+static ButtonInput button(30, 800, 400);
+
+static ButtonEvent edge(uint32_t timeMs, bool pressed)
+{
+  return button.feed({timeMs, pressed, 0});
+}
+
+void setUp()
+{
+  button = ButtonInput(30, 800, 400);
+}
+
+void tearDown() {}
+
+// Curto e o prazo devolvido por nextDeadline() para a tarefa dormir
+void test_short_press()
+{
+  TEST_ASSERT_EQUAL_UINT32(ButtonInput::NO_DEADLINE, button.nextDeadline(0));
+  TEST_ASSERT_TRUE(edge(1000, true) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(button.isPressed());
+  TEST_ASSERT_EQUAL_UINT32(800, button.nextDeadline(1000));
+  TEST_ASSERT_TRUE(edge(1100, false) == ButtonEvent::ShortPress);
+  TEST_ASSERT_EQUAL_UINT32(ButtonInput::NO_DEADLINE, button.nextDeadline(1100));
+}
+
+// Repique ao pressionar: bordas dentro da janela não geram evento
+void test_bounce_is_filtered()
+{
+  TEST_ASSERT_TRUE(edge(2000, true) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(2005, false) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(button.isPressed());
+  TEST_ASSERT_EQUAL_UINT32(30, button.nextDeadline(2005));
+  TEST_ASSERT_TRUE(edge(2010, true) == ButtonEvent::None);
+  TEST_ASSERT_EQUAL_UINT32(790, button.nextDeadline(2010));
+  TEST_ASSERT_TRUE(button.poll(2050) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(2100, false) == ButtonEvent::ShortPress);
+}
+
+// Duplo: segundo curto dentro da janela; um terceiro não encadeia
+void test_double_press()
+{
+  TEST_ASSERT_TRUE(edge(3000, true) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(3080, false) == ButtonEvent::ShortPress);
+  TEST_ASSERT_TRUE(edge(3200, true) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(3280, false) == ButtonEvent::DoublePress);
+  TEST_ASSERT_TRUE(edge(3400, true) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(3480, false) == ButtonEvent::ShortPress);
+}
+
+// Longo: sai pelo poll no prazo e a soltura não gera curto
+void test_long_press()
+{
+  TEST_ASSERT_TRUE(edge(5000, true) == ButtonEvent::None);
+  TEST_ASSERT_EQUAL_UINT32(500, button.nextDeadline(5300));
+  TEST_ASSERT_TRUE(button.poll(5799) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(button.poll(5800) == ButtonEvent::LongPress);
+  TEST_ASSERT_EQUAL_UINT32(ButtonInput::NO_DEADLINE, button.nextDeadline(5800));
+  TEST_ASSERT_TRUE(button.poll(6500) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(6600, false) == ButtonEvent::None);
+}
+
+// Pulso mais curto que o debounce: a soltura pendente só é aceita no poll, sem evento
+void test_pulse_shorter_than_debounce()
+{
+  TEST_ASSERT_TRUE(edge(7000, true) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(7010, false) == ButtonEvent::None);
+  TEST_ASSERT_EQUAL_UINT32(30, button.nextDeadline(7010));
+  TEST_ASSERT_EQUAL_UINT32(10, button.nextDeadline(7030));
+  TEST_ASSERT_TRUE(button.poll(7039) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(button.isPressed());
+  TEST_ASSERT_TRUE(button.poll(7040) == ButtonEvent::None);
+  TEST_ASSERT_FALSE(button.isPressed());
+  TEST_ASSERT_EQUAL_UINT32(ButtonInput::NO_DEADLINE, button.nextDeadline(7040));
+}
+
+// Bordas perdidas com o botão pressionado: o longo pendente é cancelado e a
+// soltura não gera curto; depois, tudo volta ao normal
+void test_resync_while_pressed()
+{
+  TEST_ASSERT_TRUE(edge(8000, true) == ButtonEvent::None);
+  button.resync(true, 8300);
+  TEST_ASSERT_TRUE(button.isPressed());
+  TEST_ASSERT_EQUAL_UINT32(ButtonInput::NO_DEADLINE, button.nextDeadline(8300));
+  TEST_ASSERT_TRUE(button.poll(9000) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(9100, false) == ButtonEvent::None);
+
+  TEST_ASSERT_TRUE(edge(9200, true) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(9280, false) == ButtonEvent::ShortPress);
+}
+
+// A soltura se perdeu: o pino solto encerra o pressionamento sem evento, e o
+// próximo curto não vira duplo com um anterior
+void test_resync_lost_release()
+{
+  TEST_ASSERT_TRUE(edge(10000, true) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(10080, false) == ButtonEvent::ShortPress);
+  TEST_ASSERT_TRUE(edge(10150, true) == ButtonEvent::None);
+  button.resync(false, 10200);
+  TEST_ASSERT_FALSE(button.isPressed());
+  TEST_ASSERT_EQUAL_UINT32(ButtonInput::NO_DEADLINE, button.nextDeadline(10200));
+  TEST_ASSERT_TRUE(button.poll(11500) == ButtonEvent::None);
+
+  TEST_ASSERT_TRUE(edge(10300, true) == ButtonEvent::None);
+  TEST_ASSERT_TRUE(edge(10380, false) == ButtonEvent::ShortPress);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_short_press);
+  RUN_TEST(test_bounce_is_filtered);
+  RUN_TEST(test_double_press);
+  RUN_TEST(test_long_press);
+  RUN_TEST(test_pulse_shorter_than_debounce);
+  RUN_TEST(test_resync_while_pressed);
+  RUN_TEST(test_resync_lost_release);
+  return UNITY_END();
+}
@@ -0,0 +1,193 @@
+// Desenho das telas (src/main.cpp, src/page_blit.h) e tráfego I2C de cada
+// quadro (src/display_flush.h) sobre os stubs de hal/native. Uso: pio test -e native
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include <board_profile.h>
+#include <display_flush.h>
+#include <images.h>
+#include <images_paged.h>
+#include <relay_state.h>
+#include <unity.h>
+
+// Funções do firmware (src/main.cpp)
+void setup();
+void drawScreen(int screen);
+void redrawDisplay();
+void drawRelayTable(Adafruit_GFX &gfx, uint32_t mask);
+RelaySnapshot applyRelayMask(uint32_t target, uint32_t touch);
+extern Adafruit_SSD1306 display;
+extern RelayState relayState;
+
+static uint8_t expected[128 * 64 / 8];
+
+// Caminho anterior da tabela de relés: bitmaps linha a linha, plotados pixel a pixel
+static void drawRelayTableBitmaps(Adafruit_GFX &gfx, uint32_t mask)
+{
+  gfx.drawBitmap(1, 27, Table, 127, 36, 1);
+  gfx.drawBitmap(4, 33, OffArrayLabel, 120, 5, 1);
+
+  for (int i = 0; i < 7; i++)
+  {
+    if (mask & (1u << i))
+    {
+      gfx.drawBitmap(i * 18 + 3, 29, TableCell, 15, 14, 1);
+      gfx.drawBitmap(i * 18 + 6, 34, OnLabel, 9, 4, 0);
+    }
+  }
+}
+
+void setUp() {}
+
+// Outros testes desenham direto no framebuffer: o próximo quadro sai completo
+void tearDown()
+{
+  redrawDisplay();
+}
+
+// blitPaged deve gerar o mesmo framebuffer que drawBitmap, no display ou em
+// outro destino (pixel a pixel), sem tocar no display nesse caso
+void test_relay_table_matches_bitmaps()
+{
+  static Adafruit_SSD1306 other(128, 64, &Wire);
+
+  for (uint32_t mask = 0; RelayOutputs::COUNT <= 7 && mask < 128; mask++)
+  {
+    display.clearDisplay();
+    drawRelayTableBitmaps(display, mask);
+    memcpy(expected, display.getBuffer(), sizeof(expected));
+
+    display.clearDisplay();
+    drawRelayTable(display, mask);
+    TEST_ASSERT_EQUAL_MEMORY(expected, display.getBuffer(), sizeof(expected));
+
+    display.clearDisplay();
+    other.clearDisplay();
+    drawRelayTable(other, mask);
+    TEST_ASSERT_EQUAL_MEMORY(expected, other.getBuffer(), sizeof(expected));
+    const uint8_t *untouched = display.getBuffer();
+    TEST_ASSERT_EQUAL_UINT8(0, untouched[0]);
+    TEST_ASSERT_EQUAL_MEMORY(untouched, untouched + 1, sizeof(expected) - 1);
+  }
+}
+
+// Recorte nas bordas, acendendo e apagando
+void test_paged_blit_clips_like_draw_bitmap()
+{
+  struct
+  {
+    const PagedBitmap &paged;
+    const uint8_t *bitmap;
+    int16_t x, y;
+  } clipped[] = {
+      {BootLogoPaged, BootLogo, -5, -3},
+      {BootLogoPaged, BootLogo, 9, 13},
+      {TableCellPaged, TableCell, 120, 57},
+      {OnLabelPaged, OnLabel, -4, 62},
+  };
+
+  for (auto &c : clipped)
+  {
+    for (uint16_t color : {1, 0})
+    {
+      display.clearDisplay();
+      display.fillRect(0, 0, 128, 64, color ? 0 : 1);
+      display.drawBitmap(c.x, c.y, c.bitmap, c.paged.width, c.paged.height, color);
+      memcpy(expected, display.getBuffer(), sizeof(expected));
+
+      display.clearDisplay();
+      display.fillRect(0, 0, 128, 64, color ? 0 : 1);
+      blitPaged(display, c.paged, c.x, c.y, color ? BlitMode::Set : BlitMode::Clear);
+      TEST_ASSERT_EQUAL_MEMORY(expected, display.getBuffer(), sizeof(expected));
+    }
+  }
+}
+
+// Bytes I2C esperados para levar o display de "before" a "after": por página
+// alterada, 7 de comando (colunas/página) + a faixa alterada + 1 de controle
+// por transação de dados (até I2C_BUFFER_LENGTH - 1 bytes cada)
+static uint32_t expectedFrameBytes(const uint8_t *before, const uint8_t *after, uint32_t &transactions)
+{
+  const size_t chunk = I2C_BUFFER_LENGTH - 1;
+  uint32_t bytes = 0;
+  transactions = 0;
+
+  for (int page = 0; page < DisplayFlush::PAGES; page++)
+  {
+    const uint8_t *a = before + page * DisplayFlush::COLUMNS;
+    const uint8_t *b = after + page * DisplayFlush::COLUMNS;
+    int first = 0;
+    int last = DisplayFlush::COLUMNS - 1;
+    while (first <= last && a[first] == b[first])
+      first++;
+    if (first > last)
+      continue;
+    while (a[last] == b[last])
+      last--;
+
+    uint32_t range = last - first + 1;
+    uint32_t chunks = (range + chunk - 1) / chunk;
+    bytes += 7 + range + chunks;
+    transactions += 1 + chunks;
+  }
+  return bytes;
+}
+
+// Desenha e confere o tráfego contra a diferença dos framebuffers
+static uint32_t frame(int screen)
+{
+  static uint8_t before[DisplayFlush::PAGES * DisplayFlush::COLUMNS];
+  memcpy(before, display.getBuffer(), sizeof(before));
+  Wire.resetCounters();
+  drawScreen(screen);
+  uint32_t transactions;
+  TEST_ASSERT_EQUAL_UINT32(expectedFrameBytes(before, display.getBuffer(), transactions), Wire.bytesSent);
+  TEST_ASSERT_EQUAL_UINT32(transactions, Wire.transactions);
+  return Wire.bytesSent;
+}
+
+// Bytes enviados pelo Wire a cada quadro de cada tela: quadro completo na
+// troca de tela, só a faixa alterada numa mudança e nada num quadro igual
+void test_frame_bytes_per_screen()
+{
+  const uint32_t fullFrame = DisplayFlush::PAGES * (7 + DisplayFlush::COLUMNS + 2);
+
+  for (int screen = 0; screen < 4; screen++)
+  {
+    redrawDisplay();
+    Wire.resetCounters();
+    drawScreen(screen);
+    TEST_ASSERT_EQUAL_UINT32(fullFrame, Wire.bytesSent);
+    TEST_ASSERT_EQUAL_UINT32(DisplayFlush::PAGES * 3, Wire.transactions);
+
+    // Quadro igual: nada no barramento (a tela de info pode mudar uma vez,
+    // pelas latências do próprio quadro recém-desenhado)
+    uint32_t bytes = frame(screen);
+    if (bytes != 0 && screen == 2)
+      bytes = frame(screen);
+    TEST_ASSERT_EQUAL_UINT32(0, bytes);
+  }
+
+  // Um relé muda: só a faixa dele
+  uint32_t mask = relayState.snapshot().mask;
+  frame(0);
+  applyRelayMask(mask ^ 0x01, 0x01);
+  uint32_t bytes = frame(0);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, bytes);
+  TEST_ASSERT_LESS_THAN_UINT32(fullFrame / 4, bytes);
+  applyRelayMask(mask, 0x01);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, frame(0));
+  TEST_ASSERT_EQUAL_UINT32(0, frame(0));
+}
+
+int main()
+{
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_relay_table_matches_bitmaps);
+  RUN_TEST(test_paged_blit_clips_like_draw_bitmap);
+  RUN_TEST(test_frame_bytes_per_screen);
+  return UNITY_END();
+}
@@ -0,0 +1,231 @@
+// Handlers HTTP dos relés (src/main.cpp) sobre os stubs de hal/native. Uso: pio test -e native
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <relay_state.h>
+#include <unity.h>
+
+// Funções do firmware (src/main.cpp)
+void setup();
+void handleGetRelayStatus(AsyncWebServerRequest *request);
+void handleRelayBatch(AsyncWebServerRequest *request);
+RelaySnapshot applyRelayMask(uint32_t target, uint32_t touch);
+extern RelayState relayState;
+extern uint16_t bootId;
+
+#ifndef STATUS_POLL_MAX_WAITERS
+#define STATUS_POLL_MAX_WAITERS 8 // Mesmo padrão do main.cpp
+#endif
+
+static AsyncWebServerRequest requests[STATUS_POLL_MAX_WAITERS + 1];
+
+static void get(AsyncWebServerRequest &request, const char *format, const char *since, const char *wait)
+{
+  request.clear();
+  if (format)
+    request.setArg("format", format);
+  if (since)
+    request.setArg("since", since);
+  if (wait)
+    request.setArg("wait", wait);
+  handleGetRelayStatus(&request);
+}
+
+static int batch(const char *mask, const char *touch)
+{
+  AsyncWebServerRequest &request = requests[0];
+  request.clear();
+  request.setArg("mask", mask);
+  if (touch)
+    request.setArg("touch", touch);
+  handleRelayBatch(&request);
+  return request.responseCode;
+}
+
+void setUp()
+{
+  applyRelayMask(0, 0x07);
+}
+
+void tearDown() {}
+
+// /relays/batch: máscara vazia ou não numérica é recusada sem mexer nos relés
+void test_batch_rejects_invalid_masks()
+{
+  applyRelayMask(0x03, 0x07);
+  uint32_t version = relayState.snapshot().version;
+  TEST_ASSERT_EQUAL_INT(400, batch("", NULL));
+  TEST_ASSERT_EQUAL_INT(400, batch("abc", NULL));
+  TEST_ASSERT_EQUAL_INT(400, batch("0x5z", NULL));
+  TEST_ASSERT_EQUAL_INT(400, batch("0x05", ""));
+  TEST_ASSERT_EQUAL_INT(400, batch("0x05", "x"));
+  TEST_ASSERT_EQUAL_UINT32(version, relayState.snapshot().version);
+
+  TEST_ASSERT_EQUAL_INT(200, batch("0x05", "0x07"));
+  TEST_ASSERT_EQUAL_HEX32(0x05, relayState.snapshot().mask & 0x07);
+  TEST_ASSERT_EQUAL_INT(200, batch("0", "0x07"));
+  TEST_ASSERT_EQUAL_HEX32(0, relayState.snapshot().mask & 0x07);
+}
+
+// /status condicional: 304 por "since" e por ETag do mesmo boot
+void test_status_not_modified()
+{
+  AsyncWebServerRequest &request = requests[0];
+  char text[24];
+  char etag[24];
+
+  RelaySnapshot before = relayState.snapshot();
+  snprintf(text, sizeof(text), "%lu", (unsigned long)before.version);
+  get(request, "mask", text, NULL);
+  TEST_ASSERT_EQUAL_INT(304, request.responseCode);
+
+  snprintf(etag, sizeof(etag), "\"%04x-%lu\"", bootId, (unsigned long)before.version);
+  request.clear();
+  request.setHeader("If-None-Match", etag);
+  handleGetRelayStatus(&request);
+  TEST_ASSERT_EQUAL_INT(304, request.responseCode);
+
+  // ETag de outro boot: estado completo
+  snprintf(etag, sizeof(etag), "\"%04x-%lu\"", (uint16_t)(bootId + 1), (unsigned long)before.version);
+  request.clear();
+  request.setHeader("If-None-Match", etag);
+  handleGetRelayStatus(&request);
+  TEST_ASSERT_EQUAL_INT(200, request.responseCode);
+  TEST_ASSERT_GREATER_THAN(100, request.responseLength);
+}
+
+// Delta a partir do histórico, nos dois formatos; versão fora do histórico: estado completo
+void test_status_delta()
+{
+  AsyncWebServerRequest &request = requests[0];
+  char text[24];
+  char body[64];
+
+  snprintf(text, sizeof(text), "%lu", (unsigned long)relayState.snapshot().version);
+  RelaySnapshot after = applyRelayMask(0x04, 0x04);
+  get(request, "mask", text, NULL);
+  int expected = snprintf(body, sizeof(body), "{\"c\":4,\"s\":%lu,\"v\":%lu}", (unsigned long)after.mask,
+                          (unsigned long)after.version);
+  TEST_ASSERT_EQUAL_INT(200, request.responseCode);
+  TEST_ASSERT_EQUAL(expected, request.responseLength);
+  get(request, NULL, text, NULL);
+  expected = snprintf(body, sizeof(body), "{\"relay2\":true,\"version\":%lu}", (unsigned long)after.version);
+  TEST_ASSERT_EQUAL_INT(200, request.responseCode);
+  TEST_ASSERT_EQUAL(expected, request.responseLength);
+
+  get(request, NULL, NULL, NULL);
+  size_t fullLength = request.responseLength;
+  snprintf(text, sizeof(text), "%lu", (unsigned long)(after.version - RelayHistory::SIZE));
+  get(request, NULL, text, NULL);
+  TEST_ASSERT_EQUAL_INT(200, request.responseCode);
+  TEST_ASSERT_EQUAL(fullLength, request.responseLength);
+}
+
+// Corpo lido de uma resposta retida (cliente lento)
+static size_t readHeld(AsyncWebServerRequest &request, char *body, size_t size)
+{
+  AsyncAbstractResponse *response = static_cast<AsyncAbstractResponse *>(request.heldResponse);
+  size_t length = 0;
+  size_t len;
+  while ((len = response->_fillBuffer((uint8_t *)body + length, size - 1 - length)) > 0)
+    length += len;
+  body[length] = '\0';
+  delete response;
+  request.heldResponse = nullptr;
+  request.holdResponse = false;
+  return length;
+}
+
+// Cliente lento: muitas respostas de outro estado saem antes de o corpo desta
+// ser lido, e ele continua sendo o do estado e do tamanho anunciados no send()
+void test_status_slow_client_keeps_its_body()
+{
+  AsyncWebServerRequest &slow = requests[1];
+  AsyncWebServerRequest &reference = requests[2];
+  slow.holdResponse = true;
+  get(slow, NULL, NULL, NULL);
+  get(reference, NULL, NULL, NULL);
+  size_t announced = reference.responseLength;
+
+  applyRelayMask(0x05, 0x07);
+  for (int i = 0; i < 4 * STATUS_POLL_MAX_WAITERS; i++)
+    get(requests[0], i & 1 ? "array" : NULL, NULL, NULL);
+
+  char body[512];
+  TEST_ASSERT_EQUAL(announced, readHeld(slow, body, sizeof(body)));
+  TEST_ASSERT_NOT_NULL(strstr(body, "\"relay0\":false,\"relay1\":false,\"relay2\":false"));
+}
+
+// Poll de todas as conexões, como o AsyncTCP faz na tarefa dele
+static void pollAll()
+{
+  for (AsyncWebServerRequest &request : requests)
+    request.poll();
+}
+
+// Long-poll: a resposta só sai no poll da conexão, por mudança ou por prazo,
+// e some com a desconexão; com a lista cheia, 304 imediato
+void test_status_long_poll()
+{
+  AsyncWebServerRequest &request = requests[0];
+  char text[24];
+
+  snprintf(text, sizeof(text), "%lu", (unsigned long)relayState.snapshot().version);
+  get(request, "mask", text, "5000");
+  pollAll();
+  TEST_ASSERT_EQUAL_INT(0, request.responseCode);
+
+  // A mudança não responde de outra tarefa: só o próximo poll envia
+  applyRelayMask(0x04, 0x04);
+  TEST_ASSERT_EQUAL_INT(0, request.responseCode);
+  pollAll();
+  TEST_ASSERT_EQUAL_INT(200, request.responseCode);
+  TEST_ASSERT_GREATER_THAN(0, request.responseLength);
+  pollAll();
+  TEST_ASSERT_EQUAL_INT(200, request.responseCode);
+
+  snprintf(text, sizeof(text), "%lu", (unsigned long)relayState.snapshot().version);
+  get(requests[0], NULL, text, "10");
+  get(requests[1], NULL, text, "5000");
+  requests[1].disconnect();
+  unsigned long start = millis();
+  while (millis() - start < 20)
+  {
+  }
+  pollAll();
+  TEST_ASSERT_EQUAL_INT(304, requests[0].responseCode);
+  TEST_ASSERT_EQUAL_INT(0, requests[1].responseCode);
+
+  // As vagas liberadas pela resposta e pela desconexão voltam a valer
+  for (AsyncWebServerRequest &waiting : requests)
+    get(waiting, NULL, text, "5000");
+  TEST_ASSERT_EQUAL_INT(0, requests[STATUS_POLL_MAX_WAITERS - 1].responseCode);
+  TEST_ASSERT_EQUAL_INT(304, requests[STATUS_POLL_MAX_WAITERS].responseCode);
+  applyRelayMask(0, 0x04);
+  pollAll();
+  for (size_t i = 0; i < STATUS_POLL_MAX_WAITERS; i++)
+    TEST_ASSERT_EQUAL_INT(200, requests[i].responseCode);
+
+  // Desconectar todas as esperas devolve todas as vagas
+  snprintf(text, sizeof(text), "%lu", (unsigned long)relayState.snapshot().version);
+  for (size_t i = 0; i < STATUS_POLL_MAX_WAITERS; i++)
+    get(requests[i], NULL, text, "5000");
+  for (size_t i = 0; i < STATUS_POLL_MAX_WAITERS; i++)
+    requests[i].disconnect();
+  get(requests[STATUS_POLL_MAX_WAITERS], NULL, text, "5000");
+  TEST_ASSERT_EQUAL_INT(0, requests[STATUS_POLL_MAX_WAITERS].responseCode);
+  requests[STATUS_POLL_MAX_WAITERS].disconnect();
+}
+
+int main()
+{
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_batch_rejects_invalid_masks);
+  RUN_TEST(test_status_not_modified);
+  RUN_TEST(test_status_delta);
+  RUN_TEST(test_status_slow_client_keeps_its_body);
+  RUN_TEST(test_status_long_poll);
+  return UNITY_END();
+}
@@ -0,0 +1,86 @@
+// Texto do /metrics (src/metrics.h) com as métricas registradas pelo firmware
+// (src/main.cpp) e por este teste. Uso: pio test -e native
+
+#include <metrics.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+// Mesma família declarada fora de sequência, com outra no meio
+Counter splitFirst("test_split_total", "Familia declarada em partes", "part=\"a\"");
+Gauge splitOther("test_other", "Outra familia no meio", NULL, []() -> uint32_t { return 7; });
+Counter splitSecond("test_split_total", "Familia declarada em partes", "part=\"b\"");
+
+static char text[32768];
+
+// Exporta tudo em leituras pequenas, como as partes de uma resposta chunked
+static size_t exportAll()
+{
+  MetricsExporter exporter;
+  size_t length = 0;
+  size_t chunk;
+  while ((chunk = exporter.read(text + length, 300)) > 0)
+  {
+    length += chunk;
+    TEST_ASSERT_LESS_THAN(sizeof(text) - 300, length);
+  }
+  text[length] = '\0';
+  return length;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Cada família tem um único HELP/TYPE e todas as amostras logo depois dele
+void test_each_family_is_declared_once_and_contiguous()
+{
+  static char families[64][64];
+  size_t familyCount = 0;
+  const char *family = NULL;
+
+  TEST_ASSERT_GREATER_THAN(0, exportAll());
+
+  for (char *line = strtok(text, "\n"); line != NULL; line = strtok(NULL, "\n"))
+  {
+    if (strncmp(line, "# HELP ", 7) == 0)
+      continue;
+
+    if (strncmp(line, "# TYPE ", 7) == 0)
+    {
+      char name[64];
+      TEST_ASSERT_EQUAL_INT(1, sscanf(line + 7, "%63s", name));
+      for (size_t i = 0; i < familyCount; i++)
+        TEST_ASSERT_TRUE_MESSAGE(strcmp(families[i], name) != 0, line);
+      TEST_ASSERT_LESS_THAN(64, familyCount);
+      strcpy(families[familyCount], name);
+      family = families[familyCount++];
+      continue;
+    }
+
+    // Amostra: nome da família, com o sufixo do histograma (_bucket, _sum, _count)
+    TEST_ASSERT_NOT_NULL(family);
+    size_t length = strlen(family);
+    TEST_ASSERT_TRUE_MESSAGE(strncmp(line, family, length) == 0, line);
+    TEST_ASSERT_TRUE_MESSAGE(strchr("{ _", line[length]) != NULL, line);
+  }
+
+  TEST_ASSERT_GREATER_THAN(10, familyCount);
+}
+
+void test_split_family_is_grouped()
+{
+  exportAll();
+
+  const char *expected = "# TYPE test_split_total counter\n"
+                         "test_split_total{part=\"a\"} 0\n"
+                         "test_split_total{part=\"b\"} 0\n";
+  TEST_ASSERT_NOT_NULL(strstr(text, expected));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_each_family_is_declared_once_and_contiguous);
+  RUN_TEST(test_split_family_is_grouped);
+  return UNITY_END();
+}
@@ -0,0 +1,82 @@
+// Cliente MQTT (src/mqtt_link.h) contra o broker simulado. Uso: pio test -e native
+
+#include <mqtt_link.h>
+#include <unity.h>
+
+static RelayState state;
+static uint32_t outputs = 0; // Saídas físicas: só alcançam o estado quando o teste manda
+
+static RelaySnapshot readState()
+{
+  return state.snapshot();
+}
+
+static uint32_t readOutputs()
+{
+  return outputs;
+}
+
+static void applyCommand(const RelayCommand &command)
+{
+  if (command.toggle)
+    state.apply(~state.snapshot().mask, command.toggle);
+  else
+    state.apply(command.target, command.touch);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Reconexão com backoff, comandos inválidos descartados e uma rajada de
+// comandos publicada como um único estado ao fim da janela; as saídas
+// alcançando o estado comandado geram outro publish
+void test_backoff_and_batched_publish()
+{
+  Client network;
+  MqttLink link(network);
+  PubSubClient &broker = link.pubSub();
+
+  broker.acceptConnections = false;
+  link.begin("broker", 1883, "bench", NULL, NULL, 7, readState, readOutputs, applyCommand);
+  TEST_ASSERT_EQUAL_UINT32(1000, link.service(0));
+  TEST_ASSERT_EQUAL_UINT32(500, link.service(500));
+  TEST_ASSERT_EQUAL_UINT32(2000, link.service(1000));
+  TEST_ASSERT_EQUAL_INT(2, broker.connectAttempts);
+
+  broker.acceptConnections = true;
+  TEST_ASSERT_EQUAL_UINT32(MqttLink::POLL_MS, link.service(3000));
+  TEST_ASSERT_EQUAL_UINT32(1, link.connectCount());
+  TEST_ASSERT_EQUAL_UINT32(1, link.publishCount());
+  TEST_ASSERT_EQUAL(2, broker.subscriptions.size());
+  TEST_ASSERT_EQUAL_STRING("{\"s\":0,\"v\":0,\"o\":0,\"n\":7}", broker.published.back().payload.c_str());
+
+  for (int i = 0; i < 50; i++)
+    broker.inject("heltec/bench/relay/3/set", "toggle");
+  broker.inject("heltec/bench/relays/set", "0x05 0x0f");
+  broker.inject("heltec/bench/relay/9/set", "on");
+  broker.inject("heltec/bench/relay/1/set", "blink");
+  broker.inject("heltec/bench/relays/set", "0x100");
+
+  link.service(4000);
+  link.service(4000 + MQTT_BATCH_WINDOW_MS - 1);
+  TEST_ASSERT_EQUAL_UINT32(1, link.publishCount());
+  link.service(4000 + MQTT_BATCH_WINDOW_MS);
+  TEST_ASSERT_EQUAL_UINT32(2, link.publishCount());
+  TEST_ASSERT_TRUE(broker.published.back().retained);
+  TEST_ASSERT_EQUAL_STRING("{\"s\":5,\"v\":51,\"o\":0,\"n\":7}", broker.published.back().payload.c_str());
+
+  link.service(5000);
+  TEST_ASSERT_EQUAL_UINT32(2, link.publishCount());
+  outputs = 0x05;
+  link.service(6000);
+  link.service(6000 + MQTT_BATCH_WINDOW_MS);
+  TEST_ASSERT_EQUAL_UINT32(3, link.publishCount());
+  TEST_ASSERT_EQUAL_STRING("{\"s\":5,\"v\":51,\"o\":5,\"n\":7}", broker.published.back().payload.c_str());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_backoff_and_batched_publish);
+  return UNITY_END();
+}
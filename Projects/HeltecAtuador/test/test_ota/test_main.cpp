@@ -0,0 +1,214 @@
+// Gravação OTA (src/ota_stream.h) e os handlers de /update (src/main.cpp)
+// sobre os stubs de hal/native. Uso: pio test -e native
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <LittleFS.h>
+#include <esp_ota_ops.h>
+#include <ota_stream.h>
+#include <atomic>
+#include <vector>
+#include <unity.h>
+
+// Funções do firmware (src/main.cpp)
+void setup();
+void handleUpdateBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+void handleUpdate(AsyncWebServerRequest *request);
+bool saveSchedule();
+extern std::atomic<bool> fsUpdating;
+extern int openFileResponses;
+
+static void sha256(const uint8_t *data, size_t length, uint8_t digest[32])
+{
+  mbedtls_sha256_context context;
+  mbedtls_sha256_init(&context);
+  mbedtls_sha256_starts(&context, 0);
+  mbedtls_sha256_update(&context, data, length);
+  mbedtls_sha256_finish(&context, digest);
+  mbedtls_sha256_free(&context);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_sha256_known_vector()
+{
+  static const uint8_t abcDigest[32] = {0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40,
+                                        0xde, 0x5d, 0xae, 0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17,
+                                        0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad};
+  uint8_t digest[32];
+  sha256((const uint8_t *)"abc", 3, digest);
+  TEST_ASSERT_EQUAL_MEMORY(abcDigest, digest, sizeof(digest));
+}
+
+// Imagem enviada em pedaços do tamanho de um segmento TCP, interrompida e
+// retomada, conferida byte a byte na partição
+void test_stream_interrupted_and_resumed()
+{
+  const size_t size = 300 * 1024 + 123;
+  std::vector<uint8_t> image(size);
+  uint32_t seed = 12345;
+  for (uint8_t &byte : image)
+  {
+    seed = seed * 1103515245 + 12345;
+    byte = seed >> 24;
+  }
+  image[0] = 0xE9;
+  uint8_t digest[32];
+  sha256(image.data(), size, digest);
+
+  static OtaStream ota;
+  const size_t chunk = 1436;
+  const size_t interrupted = 100 * 1024 + 7;
+  TEST_ASSERT_TRUE(ota.begin(OtaTarget::Firmware, size, digest, 0) == OtaResult::Ok);
+
+  uint32_t erases = espPartitionErases;
+  for (size_t offset = 0; offset < interrupted; offset += chunk)
+    TEST_ASSERT_TRUE(ota.write(&image[offset], std::min(chunk, interrupted - offset)) == OtaResult::Ok);
+
+  // Retomada: só a partir do que já foi recebido
+  TEST_ASSERT_TRUE(ota.begin(OtaTarget::Firmware, size, digest, interrupted + 1) == OtaResult::BadOffset);
+  TEST_ASSERT_TRUE(ota.begin(OtaTarget::Firmware, size, digest, ota.written()) == OtaResult::Ok);
+  for (size_t offset = ota.written(); offset < size; offset += chunk)
+    TEST_ASSERT_TRUE(ota.write(&image[offset], std::min(chunk, size - offset)) == OtaResult::Ok);
+
+  TEST_ASSERT_TRUE(ota.write(image.data(), 1) == OtaResult::TooLarge);
+  TEST_ASSERT_TRUE(ota.finish() == OtaResult::Ok);
+  erases = espPartitionErases - erases; // O último setor é gravado no finish
+  TEST_ASSERT_EQUAL_UINT32((size + OtaStream::SECTOR_SIZE - 1) / OtaStream::SECTOR_SIZE, erases);
+
+  std::vector<uint8_t> flash(size);
+  esp_partition_read(esp_ota_get_next_update_partition(NULL), 0, flash.data(), size);
+  TEST_ASSERT_TRUE(flash == image);
+
+  // Hash diferente do declarado: a partição não é ativada
+  image[size / 2] ^= 1;
+  TEST_ASSERT_TRUE(ota.begin(OtaTarget::Firmware, size, digest, 0) == OtaResult::Ok);
+  TEST_ASSERT_TRUE(ota.write(image.data(), size) == OtaResult::Ok);
+  TEST_ASSERT_TRUE(ota.finish() == OtaResult::HashMismatch);
+  TEST_ASSERT_TRUE(ota.begin(OtaTarget::Firmware, 8 * 1024 * 1024, digest, 0) == OtaResult::TooLarge);
+}
+
+static AsyncWebServerRequest first;
+static AsyncWebServerRequest second;
+static std::vector<uint8_t> dataImage(10000, 0x5A);
+static char dataHex[65];
+
+// Início de um envio de imagem do LittleFS: o corpo da requisição começa em 0
+static void startUpload(AsyncWebServerRequest &request, const char *size, size_t offset)
+{
+  char text[16];
+  request.clear();
+  request.setArg("target", "data");
+  request.setArg("size", size);
+  request.setArg("sha256", dataHex);
+  snprintf(text, sizeof(text), "%lu", (unsigned long)offset);
+  request.setArg("offset", text);
+  handleUpdateBody(&request, &dataImage[offset], 1000, 0, dataImage.size() - offset);
+}
+
+static void sendRest(AsyncWebServerRequest &request, size_t from)
+{
+  for (size_t offset = from; offset < dataImage.size(); offset += 1000)
+    handleUpdateBody(&request, &dataImage[offset], 1000, offset, dataImage.size());
+}
+
+static bool mounted()
+{
+  return LittleFS.mounted && !fsUpdating;
+}
+
+// Superblocos do LittleFS apagados: a imagem parcial não é montada
+static bool superblocksErased()
+{
+  uint8_t head[2 * OtaStream::SECTOR_SIZE];
+  esp_partition_read(esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, NULL), 0,
+                     head, sizeof(head));
+  for (uint8_t byte : head)
+  {
+    if (byte != 0xFF)
+      return false;
+  }
+  return true;
+}
+
+// Handlers de /update com imagem do LittleFS: só um envio aceito desmonta o
+// sistema de arquivos. Abandonado, segue desmontado enquanto a sessão pode ser
+// retomada; recusado, volta formatado em vez de montar uma imagem parcial.
+void test_data_upload_mounts_and_unmounts()
+{
+  uint8_t digest[32];
+  sha256(dataImage.data(), dataImage.size(), digest);
+  for (int i = 0; i < 32; i++)
+    snprintf(dataHex + i * 2, 3, "%02x", digest[i]);
+
+  // Maior que a partição: recusado sem desmontar
+  startUpload(first, "99999999", 0);
+  TEST_ASSERT_TRUE(mounted());
+  handleUpdate(&first);
+  TEST_ASSERT_EQUAL_INT(400, first.responseCode);
+  TEST_ASSERT_TRUE(mounted());
+
+  // Arquivo sendo servido: não desmonta
+  openFileResponses++;
+  startUpload(first, "10000", 0);
+  handleUpdate(&first);
+  openFileResponses--;
+  TEST_ASSERT_EQUAL_INT(503, first.responseCode);
+  TEST_ASSERT_TRUE(mounted());
+
+  // Aceito: desmonta; um segundo envio simultâneo é recusado sem mexer no primeiro
+  startUpload(first, "10000", 0);
+  TEST_ASSERT_FALSE(LittleFS.mounted);
+  TEST_ASSERT_TRUE(fsUpdating);
+  startUpload(second, "10000", 0);
+  handleUpdate(&second);
+  TEST_ASSERT_EQUAL_INT(503, second.responseCode);
+  TEST_ASSERT_FALSE(LittleFS.mounted);
+  handleUpdateBody(&first, &dataImage[1000], 1000, 1000, dataImage.size());
+
+  // Cliente desistiu no meio: a partição está parcialmente sobrescrita e a
+  // sessão pode ser retomada, então o LittleFS segue desmontado e a agenda
+  // não é gravada; a retomada conclui e remonta
+  first.disconnect();
+  TEST_ASSERT_FALSE(LittleFS.mounted);
+  TEST_ASSERT_TRUE(fsUpdating);
+  TEST_ASSERT_FALSE(saveSchedule());
+
+  // Envio sem parâmetros válidos no meio da sessão: também não remonta
+  second.clear();
+  handleUpdateBody(&second, dataImage.data(), 1000, 0, 1000);
+  handleUpdate(&second);
+  TEST_ASSERT_EQUAL_INT(400, second.responseCode);
+  TEST_ASSERT_FALSE(LittleFS.mounted);
+
+  startUpload(first, "10000", 2000);
+  TEST_ASSERT_FALSE(LittleFS.mounted);
+  sendRest(first, 3000);
+  handleUpdate(&first);
+  TEST_ASSERT_EQUAL_INT(200, first.responseCode);
+  TEST_ASSERT_TRUE(mounted());
+  TEST_ASSERT_FALSE(superblocksErased());
+  TEST_ASSERT_TRUE(saveSchedule());
+
+  // Hash diferente: falha e volta formatado
+  dataImage[0] ^= 1;
+  startUpload(first, "10000", 0);
+  sendRest(first, 1000);
+  handleUpdate(&first);
+  TEST_ASSERT_EQUAL_INT(422, first.responseCode);
+  TEST_ASSERT_TRUE(mounted());
+  TEST_ASSERT_TRUE(superblocksErased());
+  dataImage[0] ^= 1;
+}
+
+int main()
+{
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_sha256_known_vector);
+  RUN_TEST(test_stream_interrupted_and_resumed);
+  RUN_TEST(test_data_upload_mounts_and_unmounts);
+  return UNITY_END();
+}
@@ -0,0 +1,138 @@
+// Atuador dos relés (src/relay_actuator.h) com relógio virtual e o caminho do
+// firmware (src/main.cpp) sobre os stubs de hal/native. Uso: pio test -e native
+
+#include <Arduino.h>
+#include <relay_actuator.h>
+#include <relay_state.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unity.h>
+
+// Funções do firmware (src/main.cpp)
+void setup();
+RelaySnapshot applyRelayMask(uint32_t target, uint32_t touch);
+uint32_t serviceActuator();
+extern std::atomic<uint32_t> relayOutputsMask;
+
+void setUp() {}
+void tearDown() {}
+
+// Coalescência na janela e intervalo mínimo entre comutações de um relé
+void test_merge_window_and_min_switch()
+{
+  RelayActuator actuator;
+
+  actuator.begin(0, 5, 100, 0);
+  TEST_ASSERT_EQUAL_UINT32(5, actuator.update(0x01, 1000));
+  TEST_ASSERT_EQUAL_HEX32(0, actuator.outputs());
+  TEST_ASSERT_EQUAL_UINT32(RelayActuator::IDLE, actuator.update(0x00, 1002));
+  TEST_ASSERT_EQUAL_UINT32(1, actuator.cancelCount());
+  TEST_ASSERT_EQUAL_UINT32(5, actuator.update(0x01, 1010));
+  TEST_ASSERT_EQUAL_UINT32(RelayActuator::IDLE, actuator.update(0x01, 1015));
+  TEST_ASSERT_EQUAL_HEX32(0x01, actuator.outputs());
+  TEST_ASSERT_EQUAL_UINT32(1, actuator.switchCount());
+
+  // Desligar logo depois de ligar: espera o intervalo mínimo
+  TEST_ASSERT_EQUAL_UINT32(95, actuator.update(0x00, 1020));
+  TEST_ASSERT_EQUAL_HEX32(0x01, actuator.outputs());
+  actuator.update(0x00, 1115);
+  TEST_ASSERT_EQUAL_HEX32(0x00, actuator.outputs());
+  TEST_ASSERT_EQUAL_UINT32(2, actuator.switchCount());
+}
+
+// Escalonamento: um relé ligado a cada 50 ms, desligamentos sem espera
+void test_stagger_turn_on()
+{
+  RelayActuator actuator;
+
+  actuator.begin(0x10, 0, 0, 50);
+  TEST_ASSERT_EQUAL_UINT32(50, actuator.update(0x0F, 0));
+  TEST_ASSERT_EQUAL_HEX32(0x01, actuator.outputs());
+  TEST_ASSERT_EQUAL_UINT32(50, actuator.update(0x0F, 50));
+  TEST_ASSERT_EQUAL_HEX32(0x03, actuator.outputs());
+  TEST_ASSERT_EQUAL_UINT32(40, actuator.update(0x0F, 60));
+  TEST_ASSERT_EQUAL_HEX32(0x03, actuator.outputs());
+  actuator.update(0x0F, 100);
+  TEST_ASSERT_EQUAL_UINT32(RelayActuator::IDLE, actuator.update(0x0F, 150));
+  TEST_ASSERT_EQUAL_HEX32(0x0F, actuator.outputs());
+}
+
+// Rajada de comandos (cliques repetidos, script em laço) a 2 kHz por 10 s
+// simulados: intervalo mínimo respeitado em cada relé e saídas no estado
+// comandado ao fim, com menos comutações físicas que mudanças comandadas
+void test_command_burst()
+{
+  const uint32_t minSwitchMs = 100;
+  const uint32_t commands = 20000;
+  RelayState state;
+  RelayActuator actuator;
+  uint32_t lastSwitch[7] = {};
+  uint32_t changes = 0;
+
+  actuator.begin(0, 5, minSwitchMs, 0);
+  uint32_t seed = 1;
+  uint32_t deadline = RelayActuator::IDLE;
+  uint32_t now = 1000;
+
+  auto service = [&](uint32_t at)
+  {
+    uint32_t before = actuator.outputs();
+    uint32_t wait = actuator.update(state.snapshot().mask, at);
+    for (uint32_t changed = before ^ actuator.outputs(); changed != 0; changed &= changed - 1)
+    {
+      int relay = __builtin_ctz(changed);
+      TEST_ASSERT_TRUE(lastSwitch[relay] == 0 || at - lastSwitch[relay] >= minSwitchMs);
+      lastSwitch[relay] = at;
+    }
+    deadline = wait == RelayActuator::IDLE ? RelayActuator::IDLE : at + wait;
+  };
+
+  for (uint32_t i = 0; i < commands; i++)
+  {
+    now += i & 1; // 2 comandos por ms
+
+    while (deadline != RelayActuator::IDLE && deadline <= now)
+      service(deadline);
+
+    seed = seed * 1103515245 + 12345;
+    uint32_t bit = 1u << ((seed >> 16) % 7);
+    RelaySnapshot before = state.snapshot();
+    RelaySnapshot after = state.apply((seed >> 8) & 1 ? bit : 0, bit);
+    changes += __builtin_popcount(before.mask ^ after.mask);
+    service(now);
+  }
+  while (deadline != RelayActuator::IDLE)
+    service(deadline);
+
+  TEST_ASSERT_EQUAL_HEX32(state.snapshot().mask, actuator.outputs());
+  TEST_ASSERT_LESS_THAN_UINT32(changes, actuator.switchCount());
+
+  char message[80];
+  snprintf(message, sizeof(message), "%lu mudancas -> %lu comutacoes", (unsigned long)changes,
+           (unsigned long)actuator.switchCount());
+  TEST_MESSAGE(message);
+}
+
+// Firmware: estado comandado antes de a tarefa existir (restauração no boot)
+// chega às saídas sem depender de um novo comando
+void test_firmware_applies_commanded_state()
+{
+  uint32_t commanded = applyRelayMask(0x05, 0x07).mask;
+  for (uint32_t wait; (wait = serviceActuator()) != RelayActuator::IDLE;)
+    std::this_thread::sleep_for(std::chrono::milliseconds(wait));
+  TEST_ASSERT_EQUAL_HEX32(0x05, commanded & 0x07);
+  TEST_ASSERT_EQUAL_HEX32(commanded, relayOutputsMask.load());
+}
+
+int main()
+{
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_merge_window_and_min_switch);
+  RUN_TEST(test_stagger_turn_on);
+  RUN_TEST(test_command_burst);
+  RUN_TEST(test_firmware_applies_commanded_state);
+  return UNITY_END();
+}
@@ -0,0 +1,105 @@
+// Journal dos relés (src/relay_journal.h) sobre o FS simulado. Uso: pio test -e native
+
+#include <relay_journal.h>
+#include <unity.h>
+
+static fs::FS journalFs;
+static RelayJournal journal(journalFs, "/j.jnl", "/j.tmp");
+static const uint32_t masks[] = {0x01, 0x03, 0x07, 0x05, 0xF0};
+static const size_t count = sizeof(masks) / sizeof(masks[0]);
+static uint8_t full[count * JOURNAL_RECORD_SIZE];
+
+static void writeFile(const char *path, const uint8_t *bytes, size_t length)
+{
+  File file = journalFs.open(path, "w");
+  file.write(bytes, length);
+  file.close();
+}
+
+// Estado restaurado e, em seguida, um append que precisa ser relido
+static void assertRestored(bool expectFound, uint32_t expectMask)
+{
+  uint32_t mask = 0;
+  bool found = journal.restore(mask);
+  TEST_ASSERT_EQUAL(expectFound, found);
+  if (found)
+    TEST_ASSERT_EQUAL_HEX32(expectMask, mask);
+  TEST_ASSERT_FALSE(journalFs.exists("/j.tmp"));
+  TEST_ASSERT_TRUE(journal.record(0xABCD));
+  TEST_ASSERT_TRUE(journal.restore(mask));
+  TEST_ASSERT_EQUAL_HEX32(0xABCD, mask);
+}
+
+// Um registro por máscara, gravado pelo próprio journal
+void setUp()
+{
+  journalFs.remove("/j.jnl");
+  journalFs.remove("/j.tmp");
+  for (uint32_t mask : masks)
+    journal.record(mask);
+
+  File file = journalFs.open("/j.jnl", "r");
+  TEST_ASSERT_EQUAL(sizeof(full), file.size());
+  TEST_ASSERT_EQUAL(sizeof(full), file.read(full, sizeof(full)));
+  file.close();
+}
+
+void tearDown()
+{
+  journalFs.remove("/j.jnl");
+}
+
+// Queda de energia em cada byte do arquivo: vale o último registro íntegro
+// e o próximo append continua alinhado
+void test_restore_after_truncation_at_every_byte()
+{
+  for (size_t cut = 0; cut <= sizeof(full); cut++)
+  {
+    size_t intact = cut / JOURNAL_RECORD_SIZE;
+    writeFile("/j.jnl", full, cut);
+    assertRestored(intact > 0, intact > 0 ? masks[intact - 1] : 0);
+  }
+}
+
+void test_restore_after_bit_flip_at_every_byte()
+{
+  for (size_t at = 0; at < sizeof(full); at++)
+  {
+    size_t intact = at / JOURNAL_RECORD_SIZE;
+    uint8_t corrupted[sizeof(full)];
+    memcpy(corrupted, full, sizeof(full));
+    corrupted[at] ^= 0x10;
+    writeFile("/j.jnl", corrupted, sizeof(corrupted));
+    assertRestored(intact > 0, intact > 0 ? masks[intact - 1] : 0);
+  }
+}
+
+// Compactação interrompida em cada byte do temporário: truncado, é
+// descartado; íntegro, vence o journal
+void test_restore_after_interrupted_compaction()
+{
+  uint8_t compacted[JOURNAL_RECORD_SIZE];
+  JournalRecord record = {(uint16_t)(count + 1), 0x5A};
+  encodeJournalRecord(record, compacted);
+  for (size_t cut = 0; cut <= sizeof(compacted); cut++)
+  {
+    bool complete = cut == sizeof(compacted);
+    writeFile("/j.jnl", full, sizeof(full));
+    writeFile("/j.tmp", compacted, cut);
+    assertRestored(true, complete ? 0x5A : masks[count - 1]);
+
+    // Rename não atômico: journal já removido
+    journalFs.remove("/j.jnl");
+    writeFile("/j.tmp", compacted, cut);
+    assertRestored(complete, 0x5A);
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_restore_after_truncation_at_every_byte);
+  RUN_TEST(test_restore_after_bit_flip_at_every_byte);
+  RUN_TEST(test_restore_after_interrupted_compaction);
+  return UNITY_END();
+}
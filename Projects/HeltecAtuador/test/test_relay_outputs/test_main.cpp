@@ -0,0 +1,163 @@
+// Saídas por expansores I2C (src/relay_outputs.h) num barramento simulado. Uso: pio test -e native
+
+#include <relay_outputs.h>
+#include <initializer_list>
+#include <unity.h>
+
+// Barramento I2C simulado: conta transações e guarda a última de cada endereço;
+// um endereço em nack não confirma as transações (chip ausente ou travado)
+struct MockI2cBus
+{
+  void beginTransmission(uint8_t address)
+  {
+    current = address;
+    length = 0;
+  }
+  size_t write(uint8_t data)
+  {
+    buffer[length++] = data;
+    return 1;
+  }
+  uint8_t endTransmission(bool sendStop = true)
+  {
+    transactions++;
+    if (current == nack)
+      return 2; // Endereço sem ACK
+    memcpy(last[current], buffer, length);
+    lastLength[current] = length;
+    return 0;
+  }
+  bool lastIs(uint8_t address, std::initializer_list<uint8_t> bytes) const
+  {
+    return lastLength[address] == bytes.size() && memcmp(last[address], bytes.begin(), bytes.size()) == 0;
+  }
+
+  uint32_t transactions = 0;
+  uint8_t nack = 0xFF;
+  uint8_t current = 0;
+  uint8_t buffer[8];
+  size_t length = 0;
+  uint8_t last[128][8] = {};
+  size_t lastLength[128] = {};
+};
+
+void setUp() {}
+void tearDown() {}
+
+// Expansores: uma transação por chip alterado, nenhuma quando nada muda
+void test_mcp23017_writes_only_changed_chips()
+{
+  MockI2cBus bus;
+  Mcp23017RelayOutputs<MockI2cBus, 0x20, 2> mcp(bus);
+
+  mcp.begin();
+  TEST_ASSERT_EQUAL_UINT32(4, bus.transactions);
+  TEST_ASSERT_TRUE(bus.lastIs(0x21, {0x00, 0x00, 0x00}));
+
+  bus.transactions = 0;
+  mcp.write(0x00010001); // Um relé em cada chip
+  TEST_ASSERT_EQUAL_UINT32(2, bus.transactions);
+  TEST_ASSERT_TRUE(bus.lastIs(0x20, {0x14, 0x01, 0x00}));
+  TEST_ASSERT_TRUE(bus.lastIs(0x21, {0x14, 0x01, 0x00}));
+
+  bus.transactions = 0;
+  mcp.write(0x00010001);
+  TEST_ASSERT_EQUAL_UINT32(0, bus.transactions);
+
+  mcp.write(0x00018001); // Só o primeiro chip muda
+  TEST_ASSERT_EQUAL_UINT32(1, bus.transactions);
+  TEST_ASSERT_TRUE(bus.lastIs(0x20, {0x14, 0x01, 0x80}));
+}
+
+void test_pcf8575_active_low()
+{
+  MockI2cBus bus;
+  Pcf8575RelayOutputs<MockI2cBus, 0x20, 1, true> pcf(bus);
+
+  pcf.begin();
+  pcf.write(0x0001);
+  TEST_ASSERT_EQUAL_UINT32(2, bus.transactions);
+  TEST_ASSERT_TRUE(bus.lastIs(0x20, {0xFE, 0xFF}));
+}
+
+// Estado restaurado no begin(): a única escrita do PCF8575 já leva a máscara,
+// sem passar por "tudo desligado"; no MCP23017 o latch vem antes do IODIR
+void test_begin_writes_restored_state()
+{
+  MockI2cBus bus;
+  Pcf8575RelayOutputs<MockI2cBus, 0x20, 1, true> pcf(bus);
+  pcf.begin(0x8001);
+  TEST_ASSERT_EQUAL_UINT32(1, bus.transactions);
+  TEST_ASSERT_TRUE(bus.lastIs(0x20, {0xFE, 0x7F}));
+  TEST_ASSERT_EQUAL_HEX32(0x8001, pcf.applied());
+
+  MockI2cBus mcpBus;
+  Mcp23017RelayOutputs<MockI2cBus, 0x20, 2> mcp(mcpBus);
+  mcpBus.nack = 0x21;
+  mcp.begin(0x00040003);
+  TEST_ASSERT_EQUAL_HEX32(0x00000003, mcp.applied());
+  mcpBus.nack = 0xFF;
+  mcpBus.transactions = 0;
+  TEST_ASSERT_TRUE(mcp.write(0x00040003));
+  TEST_ASSERT_EQUAL_UINT32(2, mcpBus.transactions); // Só o chip que falhou: latch e IODIR
+  TEST_ASSERT_TRUE(mcpBus.lastIs(0x21, {0x00, 0x00, 0x00}));
+  TEST_ASSERT_EQUAL_HEX32(0x00040003, mcp.applied());
+}
+
+// Chip sem ACK: write() falha, applied() fica com o estado anterior só daquele
+// chip, e a próxima write() reenvia apenas o que faltou
+void test_expander_write_failure_is_retried()
+{
+  MockI2cBus bus;
+  Mcp23017RelayOutputs<MockI2cBus, 0x20, 2> mcp(bus);
+  mcp.begin();
+
+  bus.nack = 0x21;
+  TEST_ASSERT_FALSE(mcp.write(0x00020002));
+  TEST_ASSERT_EQUAL_HEX32(0x00000002, mcp.applied());
+  TEST_ASSERT_TRUE(bus.lastIs(0x20, {0x14, 0x02, 0x00}));
+
+  bus.transactions = 0;
+  TEST_ASSERT_FALSE(mcp.write(0x00020002));
+  TEST_ASSERT_EQUAL_UINT32(1, bus.transactions);
+
+  bus.nack = 0xFF;
+  bus.transactions = 0;
+  TEST_ASSERT_TRUE(mcp.write(0x00020002));
+  TEST_ASSERT_EQUAL_UINT32(1, bus.transactions);
+  TEST_ASSERT_TRUE(bus.lastIs(0x21, {0x14, 0x02, 0x00}));
+  TEST_ASSERT_EQUAL_HEX32(0x00020002, mcp.applied());
+}
+
+// Chip sem ACK no begin(): a próxima write() o inicializa (latch e IODIR)
+// mesmo sem mudança nas saídas dele
+void test_expander_begin_failure_is_retried()
+{
+  MockI2cBus bus;
+  Pcf8575RelayOutputs<MockI2cBus, 0x20, 1, true> pcf(bus);
+
+  bus.nack = 0x20;
+  pcf.begin();
+  TEST_ASSERT_FALSE(pcf.write(0));
+
+  bus.nack = 0xFF;
+  bus.transactions = 0;
+  TEST_ASSERT_TRUE(pcf.write(0));
+  TEST_ASSERT_EQUAL_UINT32(1, bus.transactions);
+  TEST_ASSERT_TRUE(bus.lastIs(0x20, {0xFF, 0xFF}));
+
+  bus.transactions = 0;
+  TEST_ASSERT_TRUE(pcf.write(0));
+  TEST_ASSERT_EQUAL_UINT32(0, bus.transactions);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_mcp23017_writes_only_changed_chips);
+  RUN_TEST(test_pcf8575_active_low);
+  RUN_TEST(test_begin_writes_restored_state);
+  RUN_TEST(test_expander_write_failure_is_retried);
+  RUN_TEST(test_expander_begin_failure_is_retried);
+  return UNITY_END();
+}
@@ -0,0 +1,212 @@
+// Agendador (src/relay_scheduler.h) com relógio virtual. Uso: pio test -e native
+
+#include <relay_scheduler.h>
+#include <unity.h>
+
+static ScheduledAction due[RelayScheduler::CAPACITY];
+
+void setUp() {}
+
+void tearDown() {}
+
+// Muitos jobs recorrentes por uma hora simulada, com avanços irregulares do
+// relógio (tarefa atrasada). Nenhuma execução pode ser antecipada nem
+// acumular atraso (deriva).
+static void runRecurringJobs(int jobs, uint32_t durationMs)
+{
+  static uint32_t fired[RelayScheduler::CAPACITY];
+  static ScheduleJob specs[RelayScheduler::CAPACITY];
+  static RelayScheduler scheduler;
+  static uint32_t now = 0; // O relógio virtual continua entre as rodadas
+
+  scheduler.clear();
+  uint32_t begin = now;
+  for (int i = 0; i < jobs; i++)
+  {
+    specs[i] = {RelayAction::Toggle, 1u << (i % 7), (uint32_t)(i * 7 % 1000), 100 + (uint32_t)(i * 37 % 5000), 0, -1};
+    fired[i] = 0;
+    TEST_ASSERT_EQUAL_INT(i, scheduler.add(specs[i], now));
+  }
+
+  uint32_t steps = 0;
+  uint32_t maxLateMs = 0;
+  while (now - begin < durationMs)
+  {
+    now += 1 + (steps * 7919) % 40; // 1 a 40 ms entre acordadas
+    size_t count;
+    while (scheduler.step(now, due, count))
+    {
+      steps++;
+      for (size_t i = 0; i < count; i++)
+      {
+        const ScheduleJob &job = specs[due[i].id];
+        uint32_t dueMs = begin + job.delayMs + fired[due[i].id]++ * job.periodMs;
+        TEST_ASSERT_TRUE_MESSAGE(now >= dueMs, "execução antecipada");
+        if (now - dueMs > maxLateMs)
+          maxLateMs = now - dueMs;
+      }
+    }
+  }
+
+  // Execuções esperadas: prazos arredondados para cima até o tick
+  for (int i = 0; i < jobs; i++)
+  {
+    const uint32_t tick = RelayScheduler::TICK_MS;
+    uint32_t expected = 0;
+    for (uint32_t dueMs = begin + specs[i].delayMs; (dueMs + tick - 1) / tick * tick <= now; dueMs += specs[i].periodMs)
+      expected++;
+    TEST_ASSERT_EQUAL_UINT32(expected, fired[i]);
+  }
+
+  // Atraso máximo: arredondamento do tick + maior intervalo entre acordadas
+  TEST_ASSERT_LESS_THAN_UINT32(RelayScheduler::TICK_MS + 40, maxLateMs);
+}
+
+void test_recurring_jobs_run_without_drift()
+{
+  runRecurringJobs(10, 3600000);
+}
+
+void test_recurring_jobs_at_capacity()
+{
+  runRecurringJobs(RelayScheduler::CAPACITY, 3600000);
+}
+
+// Avança em ticks até a próxima execução; retorna o instante
+static uint32_t nextRun(RelayScheduler &scheduler, uint32_t &now, ScheduledAction &fired)
+{
+  for (;;)
+  {
+    now += RelayScheduler::TICK_MS;
+    size_t count;
+    while (scheduler.step(now, due, count))
+      if (count > 0)
+      {
+        fired = due[0];
+        return now;
+      }
+  }
+}
+
+// Job com horário: cada início de ciclo sai marcado com o minuto do dia e o
+// retime realinha o próximo ciclo sem mexer no desligamento do pulso em curso
+void test_retime_realigns_clock_jobs()
+{
+  static RelayScheduler scheduler;
+  const uint32_t day = 24UL * 60 * 60 * 1000;
+  uint32_t now = 1000;
+  ScheduledAction fired = {};
+
+  int id = scheduler.add({RelayAction::Toggle, 0x01, 1000, day, 0, 420}, now);
+  TEST_ASSERT_EQUAL_UINT32(2000, nextRun(scheduler, now, fired));
+  TEST_ASSERT_EQUAL_INT(id, fired.id);
+  TEST_ASSERT_EQUAL_INT(420, fired.clockMinute);
+  TEST_ASSERT_TRUE(scheduler.retime(id, day - 3000, now)); // Relógio adiantou 3 s em relação ao millis()
+  TEST_ASSERT_EQUAL_UINT32(2000 + day - 3000, nextRun(scheduler, now, fired));
+  TEST_ASSERT_EQUAL_INT(420, fired.clockMinute);
+
+  scheduler.clear();
+  id = scheduler.add({RelayAction::Pulse, 0x02, 500, day, 200, 60}, now);
+  uint32_t on = nextRun(scheduler, now, fired);
+  TEST_ASSERT_TRUE(fired.action == RelayAction::On);
+  TEST_ASSERT_EQUAL_INT(60, fired.clockMinute);
+  TEST_ASSERT_TRUE(scheduler.retime(id, day + 5000, now));
+  TEST_ASSERT_EQUAL_UINT32(on + 200, nextRun(scheduler, now, fired));
+  TEST_ASSERT_TRUE(fired.action == RelayAction::Off);
+  TEST_ASSERT_EQUAL_INT(-1, fired.clockMinute);
+  TEST_ASSERT_EQUAL_UINT32(on + day + 5000, nextRun(scheduler, now, fired));
+  TEST_ASSERT_TRUE(fired.action == RelayAction::On);
+
+  // Job relativo: sem minuto
+  scheduler.clear();
+  scheduler.add({RelayAction::On, 0x04, 100, 0, 0, -1}, now);
+  nextRun(scheduler, now, fired);
+  TEST_ASSERT_EQUAL_INT(-1, fired.clockMinute);
+  TEST_ASSERT_EQUAL_INT(0, scheduler.activeCount());
+}
+
+// Execuções de uma rodada: tick em que saíram, job e ação
+struct Fired
+{
+  uint32_t tick;
+  int id;
+  RelayAction action;
+};
+
+static size_t runFor(RelayScheduler &scheduler, uint32_t now, uint32_t durationMs, bool sleep, Fired *fired,
+                     uint32_t &wakes)
+{
+  size_t total = 0;
+  uint32_t end = now + durationMs;
+  wakes = 0;
+  while ((int32_t)(end - now) > 0)
+  {
+    uint32_t wait = sleep ? scheduler.nextStepMs(now) : RelayScheduler::TICK_MS;
+    TEST_ASSERT_NOT_EQUAL(RelayScheduler::IDLE, wait);
+    now += wait < end - now ? wait : end - now;
+    wakes++;
+
+    size_t count;
+    while (scheduler.step(now, due, count))
+      for (size_t i = 0; i < count; i++)
+        fired[total++] = {now / RelayScheduler::TICK_MS, due[i].id, due[i].action};
+  }
+  return total;
+}
+
+// Tarefa que dorme o que nextStepMs() manda: executa nos mesmos ticks que a
+// que acorda a cada tick, com jobs nos quatro níveis da wheel, e só acorda
+// sem executar nada para revisar a wheel (uma vez por volta do nível 1)
+void test_sleep_until_next_step()
+{
+  static RelayScheduler ticking;
+  static RelayScheduler sleeping;
+  static Fired everyTick[12000];
+  static Fired slept[12000];
+  const uint32_t start = 12345;
+  const uint32_t duration = 3 * 3600000;
+  const ScheduleJob jobs[] = {
+      {RelayAction::Toggle, 0x01, 25, 1000, 0, -1},       // Níveis 0 e 1
+      {RelayAction::Pulse, 0x02, 70000, 600000, 300, -1}, // Nível 2
+      {RelayAction::On, 0x04, 7200000, 0, 0, -1},         // Nível 3, uma vez
+  };
+
+  TEST_ASSERT_EQUAL_UINT32(RelayScheduler::IDLE, sleeping.nextStepMs(start));
+  for (const ScheduleJob &job : jobs)
+  {
+    ticking.add(job, start);
+    sleeping.add(job, start);
+  }
+  TEST_ASSERT_EQUAL_UINT32(25, sleeping.nextStepMs(start));
+
+  uint32_t tickWakes;
+  uint32_t sleepWakes;
+  size_t expected = runFor(ticking, start, duration, false, everyTick, tickWakes);
+  size_t total = runFor(sleeping, start, duration, true, slept, sleepWakes);
+
+  TEST_ASSERT_EQUAL(expected, total);
+  for (size_t i = 0; i < total; i++)
+  {
+    TEST_ASSERT_EQUAL_UINT32(everyTick[i].tick, slept[i].tick);
+    TEST_ASSERT_EQUAL_INT(everyTick[i].id, slept[i].id);
+    TEST_ASSERT_TRUE(everyTick[i].action == slept[i].action);
+  }
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(total + duration / (64 * 64 * RelayScheduler::TICK_MS) + 1, sleepWakes);
+
+  // Job novo mais próximo que o prazo calculado: o novo prazo é o dele
+  sleeping.clear();
+  sleeping.add({RelayAction::On, 0x01, 60000, 0, 0, -1}, start);
+  TEST_ASSERT_GREATER_THAN_UINT32(30000, sleeping.nextStepMs(start));
+  sleeping.add({RelayAction::On, 0x02, 100, 0, 0, -1}, start);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(110, sleeping.nextStepMs(start));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_recurring_jobs_run_without_drift);
+  RUN_TEST(test_recurring_jobs_at_capacity);
+  RUN_TEST(test_retime_realigns_clock_jobs);
+  RUN_TEST(test_sleep_until_next_step);
+  return UNITY_END();
+}
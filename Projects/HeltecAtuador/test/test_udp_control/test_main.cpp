@@ -0,0 +1,210 @@
+// Controle binário por UDP (src/udp_control.h) e o caminho do firmware
+// (src/main.cpp) sobre os stubs de hal/native. Uso: pio test -e native
+
+#include <Arduino.h>
+#include <AsyncUDP.h>
+#include <atomic>
+#include <udp_control.h>
+#include <unity.h>
+
+// Funções do firmware (src/main.cpp)
+void setup();
+void setupUdp();
+extern AsyncUDP udp;
+extern UdpControl udpControl;
+extern RelayState relayState;
+extern std::atomic<uint32_t> relayOutputsMask;
+
+static RelayState state;
+static UdpControl control;
+static uint8_t packet[UdpControl::MAX_PACKET_SIZE];
+static uint8_t reply[UdpControl::MAX_ACK_SIZE];
+static size_t replyLength;
+static uint32_t outputs = 0; // Saídas físicas: só alcançam o estado quando o teste manda
+
+static RelaySnapshot applyMask(uint32_t target, uint32_t touch)
+{
+  return state.apply(target, touch);
+}
+
+static uint32_t readOutputs()
+{
+  return outputs;
+}
+
+static void command(uint8_t *packet, uint32_t session, uint32_t seq, uint32_t set, uint32_t clear)
+{
+  const uint32_t fields[] = {session, seq, set, clear};
+  packet[0] = UdpControl::MAGIC;
+  packet[1] = UdpControl::TYPE_COMMAND;
+  packet[2] = packet[3] = 0;
+  for (int i = 0; i < 4; i++)
+    for (int b = 0; b < 4; b++)
+      packet[4 + i * 4 + b] = fields[i] >> (b * 8);
+}
+
+static uint32_t ackField(const uint8_t *reply, size_t offset)
+{
+  return reply[offset] | (reply[offset + 1] << 8) | (reply[offset + 2] << 16) | ((uint32_t)reply[offset + 3] << 24);
+}
+
+// HMAC-SHA256 do cliente (desafio + mensagem), independente do UdpControl
+static void clientTag(const char *key, uint32_t challenge, uint8_t *packet, size_t length = UdpControl::MESSAGE_SIZE)
+{
+  uint8_t block[64] = {};
+  memcpy(block, key, strlen(key));
+  uint8_t prefix[4] = {(uint8_t)challenge, (uint8_t)(challenge >> 8), (uint8_t)(challenge >> 16),
+                       (uint8_t)(challenge >> 24)};
+  uint8_t pad[64];
+  uint8_t digest[32];
+  mbedtls_sha256_context sha;
+
+  for (size_t i = 0; i < sizeof(pad); i++)
+    pad[i] = block[i] ^ 0x36;
+  mbedtls_sha256_init(&sha);
+  mbedtls_sha256_starts(&sha, 0);
+  mbedtls_sha256_update(&sha, pad, sizeof(pad));
+  mbedtls_sha256_update(&sha, prefix, sizeof(prefix));
+  mbedtls_sha256_update(&sha, packet, length);
+  mbedtls_sha256_finish(&sha, digest);
+
+  for (size_t i = 0; i < sizeof(pad); i++)
+    pad[i] = block[i] ^ 0x5c;
+  mbedtls_sha256_starts(&sha, 0);
+  mbedtls_sha256_update(&sha, pad, sizeof(pad));
+  mbedtls_sha256_update(&sha, digest, sizeof(digest));
+  mbedtls_sha256_finish(&sha, digest);
+  mbedtls_sha256_free(&sha);
+
+  memcpy(packet + length, digest, UdpControl::TAG_SIZE);
+}
+
+static UdpStatus send(uint32_t session, uint32_t seq, uint32_t set, uint32_t clear)
+{
+  command(packet, session, seq, set, clear);
+  return control.handle(packet, UdpControl::MESSAGE_SIZE, reply, replyLength);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Pelo firmware: mesmo caminho dos handlers HTTP (applyRelayMask)
+void test_firmware_datagram_applies_and_acks()
+{
+  setupUdp();
+  command(packet, 1, 10, 0x03, 0x04);
+  AsyncUDPPacket datagram(packet, UdpControl::MESSAGE_SIZE);
+  udp.receive(datagram);
+  TEST_ASSERT_EQUAL_INT(1, datagram.replies);
+  TEST_ASSERT_EQUAL_HEX32(0x03, relayState.snapshot().mask & 0x07);
+
+  // O ack traz as saídas aplicadas, que só mudam quando o atuador escreve
+  udpControl.handle(packet, UdpControl::MESSAGE_SIZE, reply, replyLength);
+  TEST_ASSERT_EQUAL(UdpControl::ACK_SIZE, replyLength);
+  TEST_ASSERT_EQUAL_HEX32(relayState.snapshot().mask, ackField(reply, 12));
+  TEST_ASSERT_EQUAL_HEX32(relayOutputsMask.load(), ackField(reply, 20));
+}
+
+// seq por sessão: retransmissão, fora de ordem, volta do contador e máscaras inválidas
+void test_sequence_per_session()
+{
+  control.begin(7, "", applyMask, readOutputs);
+
+  uint32_t version = state.snapshot().version;
+  TEST_ASSERT_TRUE(send(7, 0xFFFFFFFF, 0x41, 0) == UdpStatus::Applied);
+  TEST_ASSERT_EQUAL(UdpControl::ACK_SIZE, replyLength);
+  TEST_ASSERT_EQUAL_HEX32(state.snapshot().mask, ackField(reply, 12));
+  TEST_ASSERT_EQUAL_UINT32(version + 1, ackField(reply, 16));
+  TEST_ASSERT_EQUAL_HEX32(0, ackField(reply, 20)); // Saídas ainda não alcançaram
+  outputs = 0x41;
+  TEST_ASSERT_TRUE(send(9, 1, 0, 0) == UdpStatus::Applied);
+  TEST_ASSERT_EQUAL_HEX32(ackField(reply, 12), ackField(reply, 20));
+  TEST_ASSERT_TRUE(send(7, 0xFFFFFFFF, 0, 0x41) == UdpStatus::Duplicate);
+  TEST_ASSERT_EQUAL_HEX32(0x41, state.snapshot().mask & 0x41);
+  TEST_ASSERT_TRUE(send(7, 0xFFFFFFFE, 0, 0x41) == UdpStatus::Stale);
+  TEST_ASSERT_TRUE(send(7, 0, 0, 0x40) == UdpStatus::Applied);
+  TEST_ASSERT_EQUAL_HEX32(0x01, state.snapshot().mask & 0x41);
+  TEST_ASSERT_TRUE(send(7, 1, 0x80, 0) == UdpStatus::Invalid);
+  TEST_ASSERT_TRUE(send(7, 1, 0x01, 0x01) == UdpStatus::Invalid);
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)UdpStatus::Invalid, reply[2]);
+  TEST_ASSERT_EQUAL_UINT8(7, reply[3]);
+  TEST_ASSERT_TRUE(send(8, 5, 0, 0) == UdpStatus::Applied);
+  TEST_ASSERT_EQUAL_HEX32(state.snapshot().mask, ackField(reply, 12));
+  TEST_ASSERT_TRUE(control.handle(packet, 12, reply, replyLength) == UdpStatus::Malformed);
+  TEST_ASSERT_EQUAL(0, replyLength);
+  packet[2] = UdpControl::FLAG_NO_ACK;
+  TEST_ASSERT_TRUE(control.handle(packet, UdpControl::MESSAGE_SIZE, reply, replyLength) == UdpStatus::Duplicate);
+  TEST_ASSERT_EQUAL(0, replyLength);
+
+  // Mais sessões que a tabela: a usada há mais tempo (7) é descartada
+  for (uint32_t session = 100; session < 100 + UdpControl::SESSIONS; session++)
+    send(session, 1, 0, 0);
+  TEST_ASSERT_TRUE(send(7, 0, 0, 0) == UdpStatus::Applied);
+}
+
+// HMAC com desafio por sessão; a tag do cliente é conferida com a do Python
+// (tools/udp_loadgen.py) para um desafio fixo
+void test_hmac_challenge_and_replay()
+{
+  static const uint8_t expectedTag[] = {0x94, 0x40, 0xb6, 0x75, 0xa8, 0x54, 0xf8, 0x7f};
+  const char *key = "bench-key";
+  command(packet, 0xCAFE, 1, 0x05, 0x02);
+  clientTag(key, 0x11223344, packet);
+  TEST_ASSERT_EQUAL_MEMORY(expectedTag, packet + UdpControl::MESSAGE_SIZE, sizeof(expectedTag));
+
+  control.begin(7, key, applyMask, readOutputs);
+  TEST_ASSERT_TRUE(control.handle(packet, UdpControl::MESSAGE_SIZE, reply, replyLength) == UdpStatus::Unauthorized);
+  TEST_ASSERT_EQUAL(0, replyLength);
+
+  // Sessão nova: desafio no ack (autenticado com ele), comando não aplicado
+  uint32_t before = state.snapshot().version;
+  TEST_ASSERT_TRUE(control.handle(packet, sizeof(packet), reply, replyLength) == UdpStatus::Challenge);
+  TEST_ASSERT_EQUAL(UdpControl::MAX_ACK_SIZE, replyLength);
+  TEST_ASSERT_EQUAL_UINT32(0, ackField(reply, 16));
+  TEST_ASSERT_EQUAL_UINT32(0, ackField(reply, 20));
+  uint32_t challenge = ackField(reply, 12);
+  uint8_t ackTag[UdpControl::TAG_SIZE];
+  memcpy(ackTag, reply + UdpControl::ACK_SIZE, sizeof(ackTag));
+  clientTag(key, challenge, reply, UdpControl::ACK_SIZE);
+  TEST_ASSERT_EQUAL_MEMORY(ackTag, reply + UdpControl::ACK_SIZE, sizeof(ackTag));
+  TEST_ASSERT_EQUAL_UINT32(before, state.snapshot().version);
+
+  clientTag(key, challenge, packet);
+  TEST_ASSERT_TRUE(control.handle(packet, sizeof(packet), reply, replyLength) == UdpStatus::Applied);
+  TEST_ASSERT_EQUAL(UdpControl::MAX_ACK_SIZE, replyLength);
+  TEST_ASSERT_EQUAL_HEX32(0x05, state.snapshot().mask & 0x07);
+  uint8_t captured[UdpControl::MAX_PACKET_SIZE];
+  memcpy(captured, packet, sizeof(captured));
+
+  // Tag errada numa sessão conhecida: o mesmo desafio de volta
+  packet[UdpControl::MAX_PACKET_SIZE - 1] ^= 1;
+  TEST_ASSERT_TRUE(control.handle(packet, sizeof(packet), reply, replyLength) == UdpStatus::Challenge);
+  TEST_ASSERT_EQUAL_UINT32(challenge, ackField(reply, 12));
+
+  // Replay depois de um reboot (tabela zerada) e depois de a sessão sair da tabela
+  applyMask(0, 0x07);
+  before = state.snapshot().version;
+  static UdpControl rebooted;
+  rebooted.begin(7, key, applyMask, readOutputs);
+  TEST_ASSERT_TRUE(rebooted.handle(captured, sizeof(captured), reply, replyLength) == UdpStatus::Challenge);
+  TEST_ASSERT_TRUE(rebooted.handle(captured, sizeof(captured), reply, replyLength) == UdpStatus::Challenge);
+  for (uint32_t session = 200; session < 200 + UdpControl::SESSIONS; session++)
+  {
+    command(packet, session, 1, 0, 0);
+    control.handle(packet, sizeof(packet), reply, replyLength);
+  }
+  TEST_ASSERT_TRUE(control.handle(captured, sizeof(captured), reply, replyLength) == UdpStatus::Challenge);
+  TEST_ASSERT_TRUE(control.handle(captured, sizeof(captured), reply, replyLength) == UdpStatus::Challenge);
+  TEST_ASSERT_EQUAL_UINT32(before, state.snapshot().version);
+}
+
+int main()
+{
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_firmware_datagram_applies_and_acks);
+  RUN_TEST(test_sequence_per_session);
+  RUN_TEST(test_hmac_challenge_and_replay);
+  return UNITY_END();
+}
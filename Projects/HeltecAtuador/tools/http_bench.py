@@ -0,0 +1,111 @@
+"""Mede latência e vazão das rotas HTTP do HeltecAtuador com vários clientes.
+
+Uso: python tools/http_bench.py <ip-do-esp32> [--clients 8] [--requests 200]
+
+Para comparar dois firmwares, grave a medição do primeiro e compare o segundo:
+  python tools/http_bench.py <ip> --save antes.json   (firmware anterior)
+  python tools/http_bench.py <ip> --compare antes.json (firmware novo)
+"""
+import argparse
+import http.client
+import json
+import statistics
+import threading
+import time
+
+
+def worker(host, port, path, count, latencies, errors):
+    conn = http.client.HTTPConnection(host, port, timeout=5)
+    for _ in range(count):
+        start = time.perf_counter()
+        try:
+            conn.request("GET", path)
+            response = conn.getresponse()
+            response.read()
+            if response.status not in (200, 304):
+                errors.append(response.status)
+        except (OSError, http.client.HTTPException) as error:
+            errors.append(str(error))
+            conn.close()
+            conn = http.client.HTTPConnection(host, port, timeout=5)
+            continue
+        latencies.append((time.perf_counter() - start) * 1000)
+    conn.close()
+
+
+def run(host, port, path, clients, requests):
+    latencies = []
+    errors = []
+    threads = [threading.Thread(target=worker, args=(host, port, path, requests, latencies, errors))
+               for _ in range(clients)]
+
+    start = time.perf_counter()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.perf_counter() - start
+
+    latencies.sort()
+    if not latencies:
+        return {"rps": 0.0, "p50": None, "p99": None, "errors": len(errors)}
+
+    p99 = latencies[min(len(latencies) - 1, int(len(latencies) * 0.99))]
+    return {"rps": len(latencies) / elapsed, "p50": statistics.median(latencies), "p99": p99,
+            "errors": len(errors)}
+
+
+def show(name, result, before=None):
+    if result["p50"] is None:
+        print(f"{name:<20} sem respostas ({result['errors']} erros)")
+        return
+
+    line = (f"{name:<20} {result['rps']:8.1f} req/s  p50 {result['p50']:7.1f} ms  "
+            f"p99 {result['p99']:7.1f} ms  erros {result['errors']}")
+    if before and before.get("p50") is not None:
+        line += (f"  | antes {before['rps']:8.1f} req/s  p50 {before['p50']:7.1f} ms  "
+                 f"p99 {before['p99']:7.1f} ms  ({result['rps'] / before['rps']:.2f}x req/s)")
+    print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=8)
+    parser.add_argument("--requests", type=int, default=200, help="requisições por cliente")
+    parser.add_argument("--save", help="grava os resultados em JSON")
+    parser.add_argument("--compare", help="JSON de uma medição anterior (--save) para comparar")
+    args = parser.parse_args()
+
+    previous = {}
+    if args.compare:
+        with open(args.compare) as file:
+            previous = json.load(file)["results"]
+
+    # Poller ocioso: com a versão atual, cada consulta é um 304 sem corpo
+    conn = http.client.HTTPConnection(args.host, args.port, timeout=5)
+    conn.request("GET", "/status?format=mask")
+    version = json.loads(conn.getresponse().read())["v"]
+    conn.close()
+
+    routes = [
+        ("/status", "/status"),
+        ("/status since", f"/status?format=mask&since={version}"),
+        ("/relay on", "/relay?relay=0&state=on"),
+        ("/relay off", "/relay?relay=0&state=off"),
+    ]
+
+    print(f"{args.clients} clientes x {args.requests} requisições")
+    results = {}
+    for name, path in routes:
+        results[name] = run(args.host, args.port, path, args.clients, args.requests)
+        show(name, results[name], previous.get(name))
+
+    if args.save:
+        with open(args.save, "w") as file:
+            json.dump({"clients": args.clients, "requests": args.requests, "results": results}, file, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,122 @@
+"""Mede o round-trip comando -> publish de estado do HeltecAtuador via MQTT.
+
+Requer um broker (ex.: mosquitto local) e o firmware com -DMQTT_BROKER.
+Uso: python tools/mqtt_bench.py <broker> heltec-xxxxxx [--commands 200] [--burst 100]
+Dependência: pip install paho-mqtt
+"""
+import argparse
+import json
+import queue
+import statistics
+import time
+
+import paho.mqtt.client as mqtt
+
+
+def make_client():
+    if hasattr(mqtt, "CallbackAPIVersion"):  # paho-mqtt 2.x
+        return mqtt.Client(mqtt.CallbackAPIVersion.VERSION2)
+    return mqtt.Client()
+
+
+def wait_state(states, predicate, timeout, seen=None):
+    deadline = time.perf_counter() + timeout
+    while True:
+        remaining = deadline - time.perf_counter()
+        if remaining <= 0:
+            return None
+        try:
+            state = states.get(timeout=remaining)
+        except queue.Empty:
+            return None
+        if seen is not None:
+            seen.append(state)
+        if predicate(state):
+            return state
+
+
+def round_trip(client, base, states, last, commands, relay):
+    """Um comando por vez: tempo até o estado com o relé alterado chegar."""
+    latencies = []
+    lost = 0
+    bit = 1 << relay
+    for _ in range(commands):
+        on = not last["s"] & bit  # Sempre inverte, para cada comando gerar um estado novo
+        start = time.perf_counter()
+        client.publish(f"{base}/relay/{relay}/set", "on" if on else "off")
+        state = wait_state(states, lambda s: bool(s["s"] & bit) == on and s["v"] > last["v"], 2.0)
+        if state is None:
+            lost += 1
+            continue
+        latencies.append((time.perf_counter() - start) * 1000)
+        last = state
+
+    latencies.sort()
+    if latencies:
+        p99 = latencies[min(len(latencies) - 1, int(len(latencies) * 0.99))]
+        print(f"round-trip   {len(latencies)} comandos  p50 {statistics.median(latencies):6.1f} ms  "
+              f"p99 {p99:6.1f} ms  perdidos {lost}")
+    return last
+
+
+def burst(client, base, states, last, count, relay_count):
+    """Rajada de comandos: vazão até o estado final e publishes gerados."""
+    all_relays = (1 << relay_count) - 1
+    masks = [(i * 37) & all_relays for i in range(count)]
+    if masks[-1] == last["s"]:
+        masks[-1] ^= 1
+
+    start = time.perf_counter()
+    for mask in masks:
+        client.publish(f"{base}/relays/set", str(mask))
+    published = time.perf_counter() - start
+
+    seen = []
+    final = wait_state(states, lambda s: s["s"] == masks[-1] and s["v"] > last["v"], 10.0, seen)
+    elapsed = time.perf_counter() - start
+    if final is None:
+        print("rajada       estado final não chegou em 10 s")
+        return last
+
+    print(f"rajada       {count} comandos em {published * 1000:.1f} ms  "
+          f"estado final em {elapsed * 1000:.1f} ms ({count / elapsed:.0f} cmd/s)  "
+          f"versões {final['v'] - last['v']}  publishes de estado {len(seen)}")
+    return final
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("broker")
+    parser.add_argument("device", help="id do cliente, ex.: heltec-a1b2c3")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--prefix", default="heltec")
+    parser.add_argument("--commands", type=int, default=200)
+    parser.add_argument("--burst", type=int, default=100)
+    parser.add_argument("--relay", type=int, default=0)
+    args = parser.parse_args()
+
+    base = f"{args.prefix}/{args.device}"
+    states = queue.Queue()
+
+    client = make_client()
+    client.on_message = lambda c, u, msg: states.put(json.loads(msg.payload))
+    client.connect(args.broker, args.port)
+    client.subscribe(f"{base}/state")
+    client.loop_start()
+
+    last = wait_state(states, lambda s: True, 5.0)  # Retido
+    if last is None:
+        print(f"sem estado retido em {base}/state; o dispositivo está conectado ao broker?")
+        return
+
+    last = round_trip(client, base, states, last, args.commands, args.relay)
+    while not states.empty():
+        states.get()
+    burst(client, base, states, last, args.burst, last["n"])
+
+    client.loop_stop()
+    client.disconnect()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,68 @@
+"""Envia firmware ou imagem do LittleFS ao HeltecAtuador por POST /update, retomando envios interrompidos.
+
+Uso: python tools/ota_upload.py <ip-do-esp32> .pio/build/heltec_wifi_lora_32_V3/firmware.bin [--target data]
+Com --resume, consulta GET /update e continua do offset já gravado (mesmo boot, mesmo arquivo).
+"""
+import argparse
+import hashlib
+import http.client
+import json
+import time
+
+
+def status(host):
+    conn = http.client.HTTPConnection(host, 80, timeout=5)
+    conn.request("GET", "/update")
+    body = json.loads(conn.getresponse().read())
+    conn.close()
+    return body
+
+
+def upload(host, target, image, digest, offset):
+    path = f"/update?target={target}&size={len(image)}&sha256={digest}&offset={offset}"
+    conn = http.client.HTTPConnection(host, 80, timeout=60)
+    conn.request("POST", path, body=image[offset:],
+                 headers={"Content-Type": "application/octet-stream"})
+    response = conn.getresponse()
+    body = response.read()
+    conn.close()
+    try:
+        return response.status, json.loads(body)
+    except ValueError:
+        return response.status, {"result": body.decode(errors="replace")}
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("host")
+    parser.add_argument("image")
+    parser.add_argument("--target", choices=["firmware", "data"], default="firmware")
+    parser.add_argument("--resume", action="store_true")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as file:
+        image = file.read()
+    digest = hashlib.sha256(image).hexdigest()
+
+    offset = 0
+    if args.resume:
+        current = status(args.host)
+        if current["active"] and current["target"] == args.target and current["size"] == len(image):
+            offset = current["offset"]
+        print(f"retomando de {offset} / {len(image)} bytes")
+
+    start = time.perf_counter()
+    code, body = upload(args.host, args.target, image, digest, offset)
+    if code == 409:  # Offset divergente: o dispositivo informa de onde retomar
+        offset = body["offset"]
+        print(f"offset divergente, retomando de {offset}")
+        code, body = upload(args.host, args.target, image, digest, offset)
+    elapsed = time.perf_counter() - start
+
+    sent = len(image) - offset
+    print(f"{code} {body.get('result')}  {sent} bytes em {elapsed:.1f} s ({sent / elapsed / 1024:.1f} KB/s)  "
+          f"no dispositivo: {body.get('bytesPerSecond', 0) / 1024:.1f} KB/s, heap +{body.get('peakHeap', 0)} B")
+
+
+if __name__ == "__main__":
+    main()
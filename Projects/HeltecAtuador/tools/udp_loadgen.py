@@ -0,0 +1,152 @@
+"""Mede a latência de atuação e a vazão do controle UDP do HeltecAtuador.
+
+Latência: um comando por vez, invertendo um relé, até o ack com o novo estado.
+Vazão: até --window comandos em voo, durante --seconds; conta acks e perdas.
+Com chave, a primeira resposta de uma sessão é o desafio (status 6), que
+entra no HMAC dos comandos seguintes; um desafio no meio da medição (reboot
+do dispositivo) é adotado e o comando conta como perdido.
+Uso: python tools/udp_loadgen.py <ip-do-esp32> [--port 4210] [--key segredo] [--commands 1000]
+"""
+import argparse
+import hashlib
+import hmac
+import os
+import socket
+import statistics
+import struct
+import time
+
+MAGIC = 0x52
+TYPE_COMMAND = 1
+TYPE_ACK = 2
+COMMAND = struct.Struct("<BBBBIIII")  # magic, tipo, flags, reservado, sessão, seq, set, clear
+ACK = struct.Struct("<BBBBIIIII")  # magic, tipo, status, relés, sessão, seq, mask, versão, saídas
+STATUS_CHALLENGE = 6
+
+
+class Link:
+    def __init__(self, host, port, key):
+        self.address = (host, port)
+        self.key = key.encode() if key else None
+        self.session = struct.unpack("<I", os.urandom(4))[0]
+        self.seq = 0
+        self.challenge = 0
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+
+    def tag(self, message, challenge):
+        return hmac.new(self.key, struct.pack("<I", challenge) + message, hashlib.sha256).digest()[:8]
+
+    def send(self, set_mask, clear_mask):
+        self.seq = (self.seq + 1) & 0xFFFFFFFF
+        message = COMMAND.pack(MAGIC, TYPE_COMMAND, 0, 0, self.session, self.seq, set_mask, clear_mask)
+        self.sock.sendto(message + self.tag(message, self.challenge) if self.key else message, self.address)
+        return self.seq
+
+    def receive(self, timeout):
+        self.sock.settimeout(timeout)
+        try:
+            data = self.sock.recv(64)
+        except socket.timeout:
+            return None
+        if len(data) < ACK.size:
+            return None
+        magic, kind, status, relays, session, seq, mask, version, outputs = ACK.unpack(data[:ACK.size])
+        challenge = mask if status == STATUS_CHALLENGE else self.challenge
+        if self.key and not hmac.compare_digest(data[ACK.size:], self.tag(data[:ACK.size], challenge)):
+            return None
+        if magic != MAGIC or kind != TYPE_ACK or session != self.session:
+            return None
+        self.challenge = challenge
+        return {"status": status, "relays": relays, "seq": seq, "mask": mask, "version": version, "outputs": outputs}
+
+
+def percentile(values, fraction):
+    return values[min(len(values) - 1, int(len(values) * fraction))]
+
+
+def latency(link, commands, relay, mask):
+    """Um comando por vez: tempo até o ack com o relé alterado."""
+    bit = 1 << relay
+    latencies = []
+    lost = 0
+    for _ in range(commands):
+        on = not mask & bit
+        start = time.perf_counter()
+        seq = link.send(bit if on else 0, 0 if on else bit)
+        while True:
+            ack = link.receive(0.5)
+            if ack is None or ack["seq"] == seq:
+                break
+        if ack is None or ack["status"] != 0:
+            lost += 1
+            continue
+        latencies.append((time.perf_counter() - start) * 1000)
+        mask = ack["mask"]
+
+    latencies.sort()
+    if latencies:
+        print(f"latência     {len(latencies)} comandos  p50 {statistics.median(latencies):6.2f} ms  "
+              f"p99 {percentile(latencies, 0.99):6.2f} ms  max {latencies[-1]:6.2f} ms  perdidos {lost}")
+    return mask
+
+
+def throughput(link, seconds, window, relay_count):
+    """Janela de comandos em voo: acks por segundo sustentados pelo dispositivo."""
+    all_relays = (1 << relay_count) - 1
+    in_flight = {}
+    acked = 0
+    lost = 0
+    rtts = []
+    start = time.perf_counter()
+    deadline = start + seconds
+    while time.perf_counter() < deadline or in_flight:
+        now = time.perf_counter()
+        while now < deadline and len(in_flight) < window:
+            set_mask = (link.seq * 37) & all_relays
+            in_flight[link.send(set_mask, all_relays & ~set_mask)] = now
+        ack = link.receive(0.2)
+        if ack is None:
+            # Sem resposta em 200 ms: o que está em voo é dado como perdido
+            lost += len(in_flight)
+            in_flight.clear()
+            continue
+        sent = in_flight.pop(ack["seq"], None)
+        if sent is not None:
+            acked += 1
+            rtts.append((time.perf_counter() - sent) * 1000)
+    elapsed = time.perf_counter() - start
+
+    rtts.sort()
+    if rtts:
+        print(f"vazão        {acked / elapsed:8.0f} cmd/s  janela {window}  acks {acked}  perdidos {lost}  "
+              f"rtt p50 {statistics.median(rtts):6.2f} ms  p99 {percentile(rtts, 0.99):6.2f} ms")
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=4210)
+    parser.add_argument("--key", help="mesma chave do UDP_CONTROL_KEY")
+    parser.add_argument("--commands", type=int, default=1000)
+    parser.add_argument("--relay", type=int, default=0)
+    parser.add_argument("--seconds", type=float, default=5.0)
+    parser.add_argument("--window", type=int, default=8)
+    args = parser.parse_args()
+
+    link = Link(args.host, args.port, args.key)
+    link.send(0, 0)  # Consulta: estado atual e número de relés
+    state = link.receive(2.0)
+    if state is not None and state["status"] == STATUS_CHALLENGE:
+        link.send(0, 0)  # Reenvia com o desafio
+        state = link.receive(2.0)
+    if state is None or state["status"] == STATUS_CHALLENGE:
+        print(f"sem resposta de {args.host}:{args.port}; a chave confere?")
+        return
+    print(f"{state['relays']} relés, estado 0x{state['mask']:x}, versão {state['version']}")
+
+    latency(link, args.commands, args.relay, state["mask"])
+    throughput(link, args.seconds, args.window, state["relays"])
+
+
+if __name__ == "__main__":
+    main()